@@ -0,0 +1,51 @@
+#include "AliasTable.h"
+
+namespace chaoskit::core {
+
+AliasTable::AliasTable(const std::vector<float> &limits)
+    : cells_(limits.size()) {
+  size_t n = limits.size();
+  if (n == 0) {
+    return;
+  }
+
+  std::vector<double> scaled(n);
+  double total = 0.;
+  float previous = 0.f;
+  for (size_t i = 0; i < n; i++) {
+    scaled[i] = std::max(0.f, limits[i] - previous);
+    previous = std::max(previous, limits[i]);
+    total += scaled[i];
+  }
+  if (total <= 0.) {
+    std::fill(scaled.begin(), scaled.end(), 0.);
+    scaled[0] = 1.;
+    total = 1.;
+  }
+
+  std::vector<uint32_t> small, large;
+  for (size_t i = 0; i < n; i++) {
+    scaled[i] *= static_cast<double>(n) / total;
+    (scaled[i] < 1. ? small : large).push_back(static_cast<uint32_t>(i));
+  }
+
+  while (!small.empty() && !large.empty()) {
+    uint32_t less = small.back();
+    uint32_t more = large.back();
+    small.pop_back();
+    large.pop_back();
+
+    cells_[less] = {static_cast<float>(scaled[less]), more};
+    scaled[more] -= 1. - scaled[less];
+    (scaled[more] < 1. ? small : large).push_back(more);
+  }
+
+  // Whatever is left is within rounding error of a full cell.
+  for (auto *rest : {&small, &large}) {
+    for (uint32_t i : *rest) {
+      cells_[i] = {1.f, i};
+    }
+  }
+}
+
+}  // namespace chaoskit::core
@@ -0,0 +1,51 @@
+#ifndef CHAOSKIT_CORE_ALIASTABLE_H
+#define CHAOSKIT_CORE_ALIASTABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace chaoskit::core {
+
+/**
+ * Samples a discrete distribution in constant time (Vose's alias method).
+ *
+ * The distribution is given by cumulative limits, like the ones of
+ * ast::LimitedBlend: outcome `i` has probability proportional to
+ * `limits[i] - limits[i - 1]`. When all limits are zero, the first outcome is
+ * always picked.
+ */
+class AliasTable {
+ public:
+  AliasTable() = default;
+  explicit AliasTable(const std::vector<float> &limits);
+
+  [[nodiscard]] size_t size() const { return cells_.size(); }
+  [[nodiscard]] bool empty() const { return cells_.empty(); }
+
+  /** Maps a number uniformly distributed in [0; size()) to an outcome. */
+  [[nodiscard]] size_t sample(float value) const {
+    auto index = std::min(static_cast<size_t>(value), cells_.size() - 1);
+    const Cell &cell = cells_[index];
+    return (value - static_cast<float>(index) < cell.probability) ? index
+                                                                  : cell.alias;
+  }
+
+  /** Draws an outcome from any Rng-like generator. */
+  template <typename Generator>
+  [[nodiscard]] size_t sample(Generator &rng) const {
+    return sample(rng.randomFloat(0.f, static_cast<float>(cells_.size())));
+  }
+
+ private:
+  struct Cell {
+    float probability;
+    uint32_t alias;
+  };
+
+  std::vector<Cell> cells_;
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_ALIASTABLE_H
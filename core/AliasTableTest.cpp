@@ -0,0 +1,65 @@
+#include <gmock/gmock.h>
+
+#include "AliasTable.h"
+
+namespace chaoskit::core {
+
+using testing::ElementsAre;
+using testing::FloatNear;
+
+class AliasTableTest : public testing::Test {};
+
+/**
+ * Samples the table at evenly spaced points and returns the share of each
+ * outcome.
+ */
+std::vector<float> distribution(const AliasTable &table) {
+  constexpr int SAMPLES = 100000;
+  std::vector<int> counts(table.size());
+  for (int i = 0; i < SAMPLES; i++) {
+    float value = (i + .5f) / SAMPLES * static_cast<float>(table.size());
+    counts[table.sample(value)]++;
+  }
+
+  std::vector<float> result;
+  for (int count : counts) {
+    result.push_back(static_cast<float>(count) / SAMPLES);
+  }
+  return result;
+}
+
+TEST_F(AliasTableTest, SingleOutcome) {
+  AliasTable table({2.f});
+
+  ASSERT_THAT(distribution(table), ElementsAre(1.f));
+}
+
+TEST_F(AliasTableTest, FollowsLimits) {
+  AliasTable table({.5f, 2.f, 2.5f, 5.f});
+
+  ASSERT_THAT(distribution(table),
+              ElementsAre(FloatNear(.1f, 1e-4f), FloatNear(.3f, 1e-4f),
+                          FloatNear(.1f, 1e-4f), FloatNear(.5f, 1e-4f)));
+}
+
+TEST_F(AliasTableTest, NeverPicksEmptyRanges) {
+  AliasTable table({0.f, 1.f, 1.f, 3.f});
+
+  ASSERT_THAT(distribution(table),
+              ElementsAre(0.f, FloatNear(1.f / 3, 1e-4f), 0.f,
+                          FloatNear(2.f / 3, 1e-4f)));
+}
+
+TEST_F(AliasTableTest, PicksFirstWhenAllEmpty) {
+  AliasTable table({0.f, 0.f, 0.f});
+
+  ASSERT_THAT(distribution(table), ElementsAre(1.f, 0.f, 0.f));
+}
+
+TEST_F(AliasTableTest, ClampsValuesAtTheEnd) {
+  AliasTable table({1.f, 2.f});
+
+  ASSERT_THAT(table.sample(2.f), 1u);
+}
+
+}  // namespace chaoskit::core
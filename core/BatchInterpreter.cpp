@@ -0,0 +1,202 @@
+#include "BatchInterpreter.h"
+
+#include <algorithm>
+#include <numeric>
+#include "BytecodeCompiler.h"
+#include "ThreadLocalRng.h"
+#include "visitRng.h"
+
+namespace chaoskit::core {
+
+namespace {
+
+size_t roundUpToSimdWidth(size_t count) {
+  return (count + MAX_SIMD_WIDTH - 1) / MAX_SIMD_WIDTH * MAX_SIMD_WIDTH;
+}
+
+}  // namespace
+
+BatchInterpreter::BatchInterpreter(const ast::System &system, size_t size,
+                                   int ttl, Params params,
+                                   std::shared_ptr<Rng> rng,
+                                   SimdLevel simdLevel)
+    : program_(compile(system)),
+      ttl_(ttl),
+      params_(std::move(params)),
+      rng_(std::move(rng)),
+      executor_(batchExecutor(simdLevel)),
+      state_(size),
+      output_(size),
+      random_(size),
+      blendOfLane_(size),
+      lanesByBlend_(size),
+      allLanes_(size) {
+  std::iota(allLanes_.begin(), allLanes_.end(), 0);
+  loadProgram();
+  randomizeParticles();
+}
+
+BatchInterpreter::BatchInterpreter(const ast::System &system, size_t size,
+                                   int ttl, Params params)
+    : BatchInterpreter(system, size, ttl, std::move(params),
+                       std::make_shared<ThreadLocalRng>()) {}
+
+void BatchInterpreter::loadProgram() {
+  blendTable_ = AliasTable(program_.limits);
+
+  registers_.assign(program_.registerCount * TILE_SIZE, 0.f);
+  for (const auto &constant : program_.constants) {
+    auto row = registers_.begin() + constant.target * TILE_SIZE;
+    std::fill(row, row + TILE_SIZE, constant.value);
+  }
+  loadParams(resolveParameters(program_, params_));
+}
+
+void BatchInterpreter::loadParams(const std::vector<float> &values) {
+  for (size_t i = 0; i < values.size(); i++) {
+    auto row =
+        registers_.begin() + program_.parameters[i].target * TILE_SIZE;
+    std::fill(row, row + TILE_SIZE, values[i]);
+  }
+}
+
+void BatchInterpreter::randomizeParticles() {
+  visitRng(*rng_, [this](auto &rng) { randomizeParticles(rng); });
+}
+
+template <typename Generator>
+void BatchInterpreter::randomizeParticles(Generator &rng) {
+  for (size_t i = 0; i < size(); i++) {
+    state_.x[i] = rng.randomFloat(-1.f, 1.f);
+    state_.y[i] = rng.randomFloat(-1.f, 1.f);
+    state_.color[i] = rng.randomFloat(0.f, 1.f);
+    state_.ttl[i] = (ttl_ == Particle::IMMORTAL) ? Particle::IMMORTAL
+                                                 : rng.randomInt(1, ttl_);
+  }
+}
+
+template <typename Generator>
+void BatchInterpreter::resetExpired(Generator &rng) {
+  for (size_t i = 0; i < size(); i++) {
+    if (state_.ttl[i] == 0) {
+      state_.x[i] = rng.randomFloat(-1.f, 1.f);
+      state_.y[i] = rng.randomFloat(-1.f, 1.f);
+      state_.color[i] = rng.randomFloat(0.f, 1.f);
+      state_.ttl[i] = ttl_;
+    }
+  }
+}
+
+void BatchInterpreter::setSystem(const ast::System &system) {
+  setSystem(system, params_);
+}
+
+void BatchInterpreter::setSystem(const ast::System &system, Params params) {
+  Program program = compile(system);
+  resolveParameters(program, params);
+
+  program_ = std::move(program);
+  params_ = std::move(params);
+  loadProgram();
+}
+
+void BatchInterpreter::setParams(Params params) {
+  loadParams(resolveParameters(program_, params));
+  params_ = std::move(params);
+}
+
+void BatchInterpreter::setTtl(int ttl) { ttl_ = ttl; }
+
+void BatchInterpreter::setRng(std::shared_ptr<Rng> rng) {
+  rng_ = std::move(rng);
+}
+
+template <typename Generator>
+void BatchInterpreter::selectBlends(Generator &rng) {
+  size_t blendCount = program_.blends.size();
+
+  // Counting sort of the particles by blend, so that each blend runs over a
+  // contiguous list of lanes.
+  blendOffsets_.assign(blendCount + 1, 0);
+  rng.fill(random_.data(), size(), 0.f, static_cast<float>(blendCount));
+  for (size_t i = 0; i < size(); i++) {
+    size_t blend = blendTable_.sample(random_[i]);
+    blendOfLane_[i] = static_cast<uint32_t>(blend);
+    ++blendOffsets_[blend + 1];
+  }
+  std::partial_sum(blendOffsets_.begin(), blendOffsets_.end(),
+                   blendOffsets_.begin());
+
+  std::vector<uint32_t> next(blendOffsets_.begin(), blendOffsets_.end() - 1);
+  for (size_t i = 0; i < size(); i++) {
+    lanesByBlend_[next[blendOfLane_[i]]++] = static_cast<uint32_t>(i);
+  }
+}
+
+void BatchInterpreter::run(const BlendCode &blend, const uint32_t *lanes,
+                           size_t count, const ParticleBatch &input,
+                           ParticleBatch &output) {
+  if (count == 0) {
+    return;
+  }
+
+  float *r = registers_.data();
+  float *inputX = r + Program::INPUT_X * TILE_SIZE;
+  float *inputY = r + Program::INPUT_Y * TILE_SIZE;
+  float *inputColor = r + Program::INPUT_COLOR * TILE_SIZE;
+  const float *outputX = r + blend.x * TILE_SIZE;
+  const float *outputY = r + blend.y * TILE_SIZE;
+  const float *outputColor = r + blend.color * TILE_SIZE;
+  const Instruction *code = program_.code.data();
+
+  for (size_t start = 0; start < count; start += TILE_SIZE) {
+    size_t tile = std::min(TILE_SIZE, count - start);
+
+    for (size_t i = 0; i < tile; i++) {
+      uint32_t lane = lanes[start + i];
+      inputX[i] = input.x[lane];
+      inputY[i] = input.y[lane];
+      inputColor[i] = input.color[lane];
+    }
+
+    executor_(code + blend.begin, code + blend.end, r, TILE_SIZE,
+              roundUpToSimdWidth(tile));
+
+    // Input and output may be the same batch: each tile reads its lanes
+    // before writing them, and no two tiles share a lane.
+    for (size_t i = 0; i < tile; i++) {
+      uint32_t lane = lanes[start + i];
+      output.x[lane] = outputX[i];
+      output.y[lane] = outputY[i];
+      output.color[lane] = outputColor[i];
+      output.ttl[lane] = input.ttl[lane];
+    }
+  }
+}
+
+void BatchInterpreter::step() {
+  visitRng(*rng_, [this](auto &rng) {
+    resetExpired(rng);
+    if (!program_.blends.empty()) {
+      selectBlends(rng);
+    }
+  });
+
+  if (!program_.blends.empty()) {
+    for (size_t blend = 0; blend < program_.blends.size(); blend++) {
+      uint32_t begin = blendOffsets_[blend];
+      run(program_.blends[blend], lanesByBlend_.data() + begin,
+          blendOffsets_[blend + 1] - begin, state_, state_);
+    }
+  }
+
+  for (auto &ttl : state_.ttl) {
+    if (ttl != Particle::IMMORTAL) {
+      --ttl;
+    }
+  }
+
+  run(program_.finalBlend, allLanes_.data(), size(), state_, output_);
+}
+
+}  // namespace chaoskit::core
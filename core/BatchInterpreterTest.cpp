@@ -0,0 +1,192 @@
+#include <gmock/gmock.h>
+
+#include <random>
+#include "BatchInterpreter.h"
+#include "BytecodeInterpreter.h"
+#include "Philox.h"
+#include "ast/helpers.h"
+#include "core/errors.h"
+#include "library/DeJong.h"
+#include "library/Drain.h"
+#include "library/coloring_methods/Distance.h"
+
+namespace chaoskit::core {
+
+using ast::helpers::make_system;
+using testing::Eq;
+
+class BatchInterpreterTest : public testing::Test {};
+
+namespace {
+
+class MersenneRng : public Rng {
+ public:
+  explicit MersenneRng(uint32_t seed) : engine_(seed) {}
+
+  float randomFloat(float min, float max) override {
+    return std::uniform_real_distribution<float>(min, max)(engine_);
+  }
+  int randomInt(int min, int max) override {
+    return std::uniform_int_distribution<int>(min, max)(engine_);
+  }
+
+ private:
+  std::mt19937 engine_;
+};
+
+/** Hides the type of a PhiloxRng, so that it's only called virtually. */
+class OpaqueRng : public Rng {
+ public:
+  explicit OpaqueRng(uint64_t seed) : rng_(seed) {}
+
+  float randomFloat(float min, float max) override {
+    return rng_.randomFloat(min, max);
+  }
+  int randomInt(int min, int max) override {
+    return rng_.randomInt(min, max);
+  }
+  void fill(float *out, size_t count, float min, float max) override {
+    rng_.fill(out, count, min, max);
+  }
+
+ private:
+  PhiloxRng rng_;
+};
+
+ast::Blend make_blend() {
+  ast::Transform pre(.9f, -.1f, .05f, .1f, .9f, -.05f);
+  ast::Transform post(1.1f, 0.f, 0.f, 0.f, .8f, .1f);
+  return ast::Blend(
+      {ast::WeightedFormula(library::DeJong().source(), .7f, .6f),
+       ast::WeightedFormula(library::Drain().source(), .3f, .4f)},
+      pre, post, library::coloring_methods::Distance().source());
+}
+
+Params make_params() {
+  Params params;
+  for (size_t blend : {size_t{0}, size_t{1},
+                       size_t{SystemIndex::FINAL_BLEND}}) {
+    params[SystemIndex{blend, 0}] = {1.4f, -2.3f, 2.4f, -2.1f};
+    params[SystemIndex{blend, 1}] = {.7f, -.5f, .3f, 0.f};
+    params[SystemIndex{blend, SystemIndex::COLORING_METHOD}] = {.2f};
+  }
+  return params;
+}
+
+}  // namespace
+
+TEST_F(BatchInterpreterTest, EmptySystem) {
+  BatchInterpreter interpreter(ast::System{}, 10);
+  auto input = interpreter.state();
+
+  interpreter.step();
+
+  for (size_t i = 0; i < input.size(); i++) {
+    ASSERT_THAT(interpreter.output()[i], Eq(input[i]));
+  }
+}
+
+TEST_F(BatchInterpreterTest, InterpretsFormula) {
+  ast::Formula formula{1.f, 2.f};
+  BatchInterpreter interpreter(make_system(formula), 100);
+
+  interpreter.step();
+
+  for (size_t i = 0; i < interpreter.size(); i++) {
+    ASSERT_THAT(interpreter.output()[i],
+                Eq(Particle{{1.f, 2.f},
+                            interpreter.state().color[i],
+                            Particle::IMMORTAL}));
+  }
+}
+
+TEST_F(BatchInterpreterTest, DecrementsTtl) {
+  BatchInterpreter interpreter(ast::System{}, 10, 5);
+  for (size_t i = 0; i < interpreter.size(); i++) {
+    interpreter.state().ttl[i] = 5;
+  }
+
+  interpreter.step();
+
+  for (size_t i = 0; i < interpreter.size(); i++) {
+    ASSERT_THAT(interpreter.output().ttl[i], Eq(4));
+  }
+}
+
+TEST_F(BatchInterpreterTest, ThrowsOnMissingParameter) {
+  using namespace ast::helpers;
+  ParameterHelper params;
+  auto system = make_system(ast::Formula{params[0], params[1]});
+
+  ASSERT_THROW(BatchInterpreter(system, 10), MissingParameterError);
+}
+
+TEST_F(BatchInterpreterTest, MatchesBytecodeInterpreterPerParticle) {
+  // With a single blend there's nothing random about an iteration, so every
+  // lane has to follow the scalar interpreter exactly.
+  ast::System system{{ast::LimitedBlend(make_blend(), 1.f)}, make_blend()};
+  BatchInterpreter batch(system, 1000, Particle::IMMORTAL, make_params(),
+                         std::make_shared<MersenneRng>(1));
+  BytecodeInterpreter bytecode(system, Particle::IMMORTAL, make_params(),
+                               std::make_shared<MersenneRng>(2));
+
+  for (int step = 0; step < 20; step++) {
+    auto input = batch.state();
+    batch.step();
+
+    for (size_t i = 0; i < batch.size(); i++) {
+      auto expected = bytecode(input[i]);
+      ASSERT_THAT(batch.state()[i], Eq(expected.next_state))
+          << "at step " << step << ", particle " << i;
+      ASSERT_THAT(batch.output()[i], Eq(expected.output))
+          << "at step " << step << ", particle " << i;
+    }
+  }
+}
+
+TEST_F(BatchInterpreterTest, BindingTheRngKeepsItsStream) {
+  ast::System system{{ast::LimitedBlend(make_blend(), 1.f),
+                      ast::LimitedBlend(make_blend(), 2.f)},
+                     ast::Blend()};
+  BatchInterpreter bound(system, 333, 20, make_params(),
+                         std::make_shared<PhiloxRng>(7));
+  BatchInterpreter opaque(system, 333, 20, make_params(),
+                          std::make_shared<OpaqueRng>(7));
+
+  for (int step = 0; step < 100; step++) {
+    bound.step();
+    opaque.step();
+
+    for (size_t i = 0; i < bound.size(); i++) {
+      ASSERT_THAT(bound.output()[i], Eq(opaque.output()[i]))
+          << "at step " << step << ", particle " << i;
+    }
+  }
+}
+
+TEST_F(BatchInterpreterTest, SimdLevelsAgree) {
+  ast::System system{{ast::LimitedBlend(make_blend(), 1.f),
+                      ast::LimitedBlend(make_blend(), 2.f)},
+                     ast::Blend()};
+
+  auto make_interpreter = [&](SimdLevel level) {
+    return BatchInterpreter(system, 333, 20, make_params(),
+                            std::make_shared<MersenneRng>(1), level);
+  };
+  BatchInterpreter scalar = make_interpreter(SimdLevel::Scalar);
+  BatchInterpreter sse41 = make_interpreter(SimdLevel::Sse41);
+  BatchInterpreter avx2 = make_interpreter(SimdLevel::Avx2);
+
+  for (int step = 0; step < 100; step++) {
+    scalar.step();
+    sse41.step();
+    avx2.step();
+
+    for (size_t i = 0; i < scalar.size(); i++) {
+      ASSERT_THAT(sse41.output()[i], Eq(scalar.output()[i]));
+      ASSERT_THAT(avx2.output()[i], Eq(scalar.output()[i]));
+    }
+  }
+}
+
+}  // namespace chaoskit::core
@@ -0,0 +1,31 @@
+#ifndef CHAOSKIT_CORE_BIN_H
+#define CHAOSKIT_CORE_BIN_H
+
+namespace chaoskit::core {
+
+/**
+ * What a histogram accumulates in a pixel: the weight of the samples that
+ * hit it and the sum of their color coordinates, each times its weight.
+ * Colors are only looked up when the histogram is displayed.
+ */
+struct Bin {
+  Bin() : density(0.f), color(0.f) {}
+  Bin(float density, float color) : density(density), color(color) {}
+
+  float density, color;
+
+  Bin& operator+=(const Bin& other) {
+    density += other.density;
+    color += other.color;
+    return *this;
+  }
+  Bin& operator*=(float factor) {
+    density *= factor;
+    color *= factor;
+    return *this;
+  }
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_BIN_H
@@ -0,0 +1,61 @@
+#include "Bytecode.h"
+#include "errors.h"
+
+namespace chaoskit::core {
+
+namespace {
+
+void printBlend(std::ostream &stream, const Program &program,
+                const BlendCode &blend) {
+  for (uint32_t i = blend.begin; i < blend.end; i++) {
+    const auto &instruction = program.code[i];
+    stream << "  r" << instruction.out << " = " << instruction.op << " r"
+           << instruction.a;
+    if (instruction.op >= +OpCode::ADD) {
+      stream << ", r" << instruction.b;
+    }
+    stream << std::endl;
+  }
+  stream << "  -> (r" << blend.x << ", r" << blend.y << "), r" << blend.color
+         << std::endl;
+}
+
+}  // namespace
+
+std::vector<float> resolveParameters(const Program &program,
+                                     const Params &params) {
+  std::vector<float> values;
+  values.reserve(program.parameters.size());
+  for (const auto &parameter : program.parameters) {
+    const auto &slot = parameter.value;
+    try {
+      values.push_back(params.at(slot.index).at(slot.parameter));
+    } catch (std::out_of_range &e) {
+      throw MissingParameterError(slot.index, slot.parameter);
+    }
+  }
+  return values;
+}
+
+std::ostream &operator<<(std::ostream &stream, const Program &program) {
+  stream << "Program (" << program.registerCount << " registers)" << std::endl;
+  for (const auto &constant : program.constants) {
+    stream << "r" << constant.target << " := " << constant.value << std::endl;
+  }
+  for (const auto &parameter : program.parameters) {
+    const auto &slot = parameter.value;
+    stream << "r" << parameter.target << " := param " << slot.parameter
+           << " of (" << slot.index.blend << ", " << slot.index.formula << ")"
+           << std::endl;
+  }
+  for (size_t i = 0; i < program.blends.size(); i++) {
+    stream << "blend " << i << " (limit " << program.limits[i]
+           << "):" << std::endl;
+    printBlend(stream, program, program.blends[i]);
+  }
+  stream << "final blend:" << std::endl;
+  printBlend(stream, program, program.finalBlend);
+  return stream;
+}
+
+}  // namespace chaoskit::core
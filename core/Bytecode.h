@@ -0,0 +1,93 @@
+#ifndef CHAOSKIT_CORE_BYTECODE_H
+#define CHAOSKIT_CORE_BYTECODE_H
+
+#include <enum.h>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "Params.h"
+#include "SystemIndex.h"
+
+namespace chaoskit::core {
+
+BETTER_ENUM(OpCode, uint8_t,
+            // Unary functions, reading register `a`.
+            SIN, COS, TAN, MINUS, SQRT, ATAN, TRUNC, EXP, FLOOR, CEIL, SIGNUM,
+            ABS, NOT, FRAC,
+            // Binary functions, reading registers `a` and `b`.
+            ADD, SUBTRACT, MULTIPLY, DIVIDE, POWER, MODULO, AND, OR, LESS_THAN,
+            GREATER_THAN, EQUALS, LESS_THAN_OR_EQUAL, GREATER_THAN_OR_EQUAL,
+            DISTANCE)
+
+using Register = uint16_t;
+
+struct Instruction {
+  OpCode op;
+  Register out;
+  Register a;
+  Register b;
+};
+
+/** A register that has to be initialized before running any code. */
+template <typename T>
+struct RegisterInitializer {
+  Register target;
+  T value;
+};
+
+struct ParameterSlot {
+  SystemIndex index;
+  size_t parameter;
+
+  bool operator==(const ParameterSlot &other) const {
+    return index == other.index && parameter == other.parameter;
+  }
+};
+
+/**
+ * Straight-line code for a single blend. Running the instructions in
+ * [begin; end) leaves the resulting particle in registers `x`, `y` and
+ * `color`.
+ */
+struct BlendCode {
+  uint32_t begin = 0;
+  uint32_t end = 0;
+  Register x = 0;
+  Register y = 0;
+  Register color = 0;
+};
+
+/**
+ * A system compiled to a register machine.
+ *
+ * Registers 0–2 hold the input particle. Constants and parameters live in
+ * registers that are written once when the program (or its parameters) is
+ * loaded, so the instructions themselves never read anything but registers.
+ */
+struct Program {
+  static const Register INPUT_X = 0;
+  static const Register INPUT_Y = 1;
+  static const Register INPUT_COLOR = 2;
+  static const Register FIRST_FREE_REGISTER = 3;
+
+  std::vector<Instruction> code;
+  std::vector<RegisterInitializer<float>> constants;
+  std::vector<RegisterInitializer<ParameterSlot>> parameters;
+  std::vector<BlendCode> blends;
+  std::vector<float> limits;
+  BlendCode finalBlend;
+  Register registerCount = FIRST_FREE_REGISTER;
+};
+
+/**
+ * Looks up the values of Program::parameters, in the same order. Throws
+ * MissingParameterError if any of them is missing.
+ */
+std::vector<float> resolveParameters(const Program &program,
+                                     const Params &params);
+
+std::ostream &operator<<(std::ostream &stream, const Program &program);
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_BYTECODE_H
@@ -0,0 +1,259 @@
+#include "BytecodeCompiler.h"
+
+#include <cstring>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include "ast/ast.h"
+#include "optimize.h"
+
+namespace chaoskit::core {
+
+using ast::apply_visitor;
+
+namespace {
+
+OpCode opCode(ast::UnaryFunction_Type type) {
+  switch (type) {
+    case ast::UnaryFunction_Type::SIN:
+      return OpCode::SIN;
+    case ast::UnaryFunction_Type::COS:
+      return OpCode::COS;
+    case ast::UnaryFunction_Type::TAN:
+      return OpCode::TAN;
+    case ast::UnaryFunction_Type::MINUS:
+      return OpCode::MINUS;
+    case ast::UnaryFunction_Type::SQRT:
+      return OpCode::SQRT;
+    case ast::UnaryFunction_Type::ATAN:
+      return OpCode::ATAN;
+    case ast::UnaryFunction_Type::TRUNC:
+      return OpCode::TRUNC;
+    case ast::UnaryFunction_Type::EXP:
+      return OpCode::EXP;
+    case ast::UnaryFunction_Type::FLOOR:
+      return OpCode::FLOOR;
+    case ast::UnaryFunction_Type::CEIL:
+      return OpCode::CEIL;
+    case ast::UnaryFunction_Type::SIGNUM:
+      return OpCode::SIGNUM;
+    case ast::UnaryFunction_Type::ABS:
+      return OpCode::ABS;
+    case ast::UnaryFunction_Type::NOT:
+      return OpCode::NOT;
+    case ast::UnaryFunction_Type::FRAC:
+      return OpCode::FRAC;
+  }
+  throw std::invalid_argument(std::string("Unknown unary function: ") +
+                              type._to_string());
+}
+
+OpCode opCode(ast::BinaryFunction_Type type) {
+  switch (type) {
+    case ast::BinaryFunction_Type::ADD:
+      return OpCode::ADD;
+    case ast::BinaryFunction_Type::SUBTRACT:
+      return OpCode::SUBTRACT;
+    case ast::BinaryFunction_Type::MULTIPLY:
+      return OpCode::MULTIPLY;
+    case ast::BinaryFunction_Type::DIVIDE:
+      return OpCode::DIVIDE;
+    case ast::BinaryFunction_Type::POWER:
+      return OpCode::POWER;
+    case ast::BinaryFunction_Type::MODULO:
+      return OpCode::MODULO;
+    case ast::BinaryFunction_Type::AND:
+      return OpCode::AND;
+    case ast::BinaryFunction_Type::OR:
+      return OpCode::OR;
+    case ast::BinaryFunction_Type::LESS_THAN:
+      return OpCode::LESS_THAN;
+    case ast::BinaryFunction_Type::GREATER_THAN:
+      return OpCode::GREATER_THAN;
+    case ast::BinaryFunction_Type::EQUALS:
+      return OpCode::EQUALS;
+    case ast::BinaryFunction_Type::LESS_THAN_OR_EQUAL:
+      return OpCode::LESS_THAN_OR_EQUAL;
+    case ast::BinaryFunction_Type::GREATER_THAN_OR_EQUAL:
+      return OpCode::GREATER_THAN_OR_EQUAL;
+    case ast::BinaryFunction_Type::DISTANCE:
+      return OpCode::DISTANCE;
+  }
+  throw std::invalid_argument(std::string("Unknown binary function: ") +
+                              type._to_string());
+}
+
+class Compiler {
+ public:
+  Program compile(const ast::System &system) {
+    for (size_t i = 0; i < system.blends().size(); i++) {
+      const auto &blend = system.blends()[i];
+      program_.blends.push_back(compile(blend.blend(), i));
+      program_.limits.push_back(blend.limit());
+    }
+    program_.finalBlend =
+        compile(system.final_blend(), SystemIndex::FINAL_BLEND);
+    return std::move(program_);
+  }
+
+  Register operator()(float number) {
+    // Compare bit patterns, so that 0 and -0 get separate registers.
+    auto [it, inserted] = constants_.try_emplace(bits(number), 0);
+    if (inserted) {
+      it->second = allocate();
+      program_.constants.push_back({it->second, number});
+    }
+    return it->second;
+  }
+
+  Register operator()(const ast::Input &input) const {
+    switch (input.type()) {
+      case ast::Input_Type::X:
+        return Program::INPUT_X;
+      case ast::Input_Type::Y:
+        return Program::INPUT_Y;
+      case ast::Input_Type::COLOR:
+        return Program::INPUT_COLOR;
+    }
+    throw std::invalid_argument("Unknown input type");
+  }
+
+  Register operator()(const ast::Output &output) const {
+    switch (output.type()) {
+      case ast::Output_Type::X:
+        return outputX_;
+      case ast::Output_Type::Y:
+        return outputY_;
+    }
+    throw std::invalid_argument("Unknown output type");
+  }
+
+  Register operator()(const ast::Parameter &parameter) {
+    ParameterSlot slot{index_, parameter.index()};
+    for (uint32_t i = 0; i < program_.parameters.size(); i++) {
+      if (program_.parameters[i].value == slot) {
+        return program_.parameters[i].target;
+      }
+    }
+
+    Register target = allocate();
+    program_.parameters.push_back({target, slot});
+    return target;
+  }
+
+  Register operator()(const ast::UnaryFunction &function) {
+    Register argument = apply_visitor(*this, function.argument());
+    return emit(opCode(function.type()), argument, argument);
+  }
+
+  Register operator()(const ast::BinaryFunction &function) {
+    Register first = apply_visitor(*this, function.first());
+    Register second = apply_visitor(*this, function.second());
+    return emit(opCode(function.type()), first, second);
+  }
+
+ private:
+  Program program_;
+  std::map<uint32_t, Register> constants_;
+  std::map<std::tuple<uint8_t, Register, Register>, Register> values_;
+  SystemIndex index_;
+  Register outputX_ = Program::INPUT_X;
+  Register outputY_ = Program::INPUT_Y;
+
+  static uint32_t bits(float number) {
+    uint32_t result;
+    static_assert(sizeof(result) == sizeof(number));
+    std::memcpy(&result, &number, sizeof(result));
+    return result;
+  }
+
+  Register allocate() {
+    if (program_.registerCount == std::numeric_limits<Register>::max()) {
+      throw std::length_error("Too many registers required by the system");
+    }
+    return program_.registerCount++;
+  }
+
+  /** Emits an instruction, unless the same one was already emitted. */
+  Register emit(OpCode op, Register a, Register b) {
+    auto [it, inserted] =
+        values_.try_emplace(std::make_tuple(op._to_integral(), a, b), 0);
+    if (inserted) {
+      it->second = allocate();
+      program_.code.push_back({op, it->second, a, b});
+    }
+    return it->second;
+  }
+
+  Register emitWeighted(Register value, float weight) {
+    return weight == 1.f ? value
+                         : emit(OpCode::MULTIPLY, value, (*this)(weight));
+  }
+
+  /** Emits code for a * x + b * y + c, in the same order as the AST would. */
+  Register emitAffine(float a, float b, float c, Register x, Register y) {
+    Register ax = emit(OpCode::MULTIPLY, (*this)(a), x);
+    Register by = emit(OpCode::MULTIPLY, (*this)(b), y);
+    return emit(OpCode::ADD, emit(OpCode::ADD, ax, by), (*this)(c));
+  }
+
+  void emitTransform(const ast::Transform &transform) {
+    if (transform == ast::Transform::identity()) {
+      return;
+    }
+
+    const auto &params = transform.params();
+    Register x =
+        emitAffine(params[0], params[1], params[2], outputX_, outputY_);
+    Register y =
+        emitAffine(params[3], params[4], params[5], outputX_, outputY_);
+    outputX_ = x;
+    outputY_ = y;
+  }
+
+  BlendCode compile(const ast::Blend &blend, size_t blendIndex) {
+    BlendCode result;
+    result.begin = static_cast<uint32_t>(program_.code.size());
+    // Values computed by other blends are not available when this one runs.
+    values_.clear();
+    index_ = SystemIndex{blendIndex, 0};
+    outputX_ = Program::INPUT_X;
+    outputY_ = Program::INPUT_Y;
+
+    emitTransform(blend.pre());
+
+    if (!blend.formulas().empty()) {
+      // Start the sum from 0 like the tree-walking interpreter does, which
+      // matters for formulas that produce -0.
+      Register sumX = (*this)(0.f);
+      Register sumY = sumX;
+      for (const auto &formula : blend.formulas()) {
+        Register x = apply_visitor(*this, formula.formula().x());
+        Register y = apply_visitor(*this, formula.formula().y());
+        sumX = emit(OpCode::ADD, sumX, emitWeighted(x, formula.weight_x()));
+        sumY = emit(OpCode::ADD, sumY, emitWeighted(y, formula.weight_y()));
+        index_.formula++;
+      }
+      outputX_ = sumX;
+      outputY_ = sumY;
+    }
+
+    emitTransform(blend.post());
+
+    index_.formula = SystemIndex::COLORING_METHOD;
+    result.color = apply_visitor(*this, blend.coloringMethod());
+    result.x = outputX_;
+    result.y = outputY_;
+    result.end = static_cast<uint32_t>(program_.code.size());
+    return result;
+  }
+};
+
+}  // namespace
+
+Program compile(const ast::System &system) {
+  return Compiler().compile(optimize(system));
+}
+
+}  // namespace chaoskit::core
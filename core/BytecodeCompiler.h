@@ -0,0 +1,13 @@
+#ifndef CHAOSKIT_CORE_BYTECODECOMPILER_H
+#define CHAOSKIT_CORE_BYTECODECOMPILER_H
+
+#include <ast/System.h>
+#include "Bytecode.h"
+
+namespace chaoskit::core {
+
+Program compile(const ast::System &system);
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_BYTECODECOMPILER_H
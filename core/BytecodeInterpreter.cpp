@@ -0,0 +1,243 @@
+#include "BytecodeInterpreter.h"
+
+#include <algorithm>
+#include <cmath>
+#include "BytecodeCompiler.h"
+#include "ThreadLocalRng.h"
+#include "visitRng.h"
+
+namespace chaoskit::core {
+
+namespace {
+
+void execute(const Instruction *begin, const Instruction *end, float *r) {
+  for (const Instruction *i = begin; i != end; ++i) {
+    switch (i->op) {
+      case OpCode::SIN:
+        r[i->out] = sinf(r[i->a]);
+        break;
+      case OpCode::COS:
+        r[i->out] = cosf(r[i->a]);
+        break;
+      case OpCode::TAN:
+        r[i->out] = tanf(r[i->a]);
+        break;
+      case OpCode::MINUS:
+        r[i->out] = -r[i->a];
+        break;
+      case OpCode::SQRT:
+        r[i->out] = sqrtf(r[i->a]);
+        break;
+      case OpCode::ATAN:
+        r[i->out] = atanf(r[i->a]);
+        break;
+      case OpCode::TRUNC:
+        r[i->out] = truncf(r[i->a]);
+        break;
+      case OpCode::EXP:
+        r[i->out] = expf(r[i->a]);
+        break;
+      case OpCode::FLOOR:
+        r[i->out] = floorf(r[i->a]);
+        break;
+      case OpCode::CEIL:
+        r[i->out] = ceilf(r[i->a]);
+        break;
+      case OpCode::SIGNUM:
+        r[i->out] = std::signbit(r[i->a]) ? -1.f : 1.f;
+        break;
+      case OpCode::ABS:
+        r[i->out] = fabsf(r[i->a]);
+        break;
+      case OpCode::NOT:
+        r[i->out] = !r[i->a];
+        break;
+      case OpCode::FRAC: {
+        float unused;
+        r[i->out] = modff(r[i->a], &unused);
+        break;
+      }
+      case OpCode::ADD:
+        r[i->out] = r[i->a] + r[i->b];
+        break;
+      case OpCode::SUBTRACT:
+        r[i->out] = r[i->a] - r[i->b];
+        break;
+      case OpCode::MULTIPLY:
+        r[i->out] = r[i->a] * r[i->b];
+        break;
+      case OpCode::DIVIDE:
+        r[i->out] = r[i->a] / r[i->b];
+        break;
+      case OpCode::POWER:
+        r[i->out] = powf(r[i->a], r[i->b]);
+        break;
+      case OpCode::MODULO:
+        r[i->out] = fmodf(r[i->a], r[i->b]);
+        break;
+      case OpCode::AND:
+        r[i->out] = r[i->a] && r[i->b];
+        break;
+      case OpCode::OR:
+        r[i->out] = r[i->a] || r[i->b];
+        break;
+      case OpCode::LESS_THAN:
+        r[i->out] = r[i->a] < r[i->b];
+        break;
+      case OpCode::GREATER_THAN:
+        r[i->out] = r[i->a] > r[i->b];
+        break;
+      case OpCode::EQUALS:
+        r[i->out] = r[i->a] == r[i->b];
+        break;
+      case OpCode::LESS_THAN_OR_EQUAL:
+        r[i->out] = r[i->a] <= r[i->b];
+        break;
+      case OpCode::GREATER_THAN_OR_EQUAL:
+        r[i->out] = r[i->a] >= r[i->b];
+        break;
+      case OpCode::DISTANCE:
+        r[i->out] = std::abs(r[i->a] - r[i->b]);
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+BytecodeInterpreter::BytecodeInterpreter(const ast::System &system, int ttl,
+                                         Params params,
+                                         std::shared_ptr<Rng> rng)
+    : program_(compile(system)),
+      ttl_(ttl),
+      params_(std::move(params)),
+      rng_(std::move(rng)) {
+  loadProgram();
+}
+
+BytecodeInterpreter::BytecodeInterpreter(const ast::System &system, int ttl,
+                                         Params params)
+    : BytecodeInterpreter(system, ttl, std::move(params),
+                          std::make_shared<ThreadLocalRng>()) {}
+
+void BytecodeInterpreter::loadProgram() {
+  blendTable_ = AliasTable(program_.limits);
+  setBackend(requestedBackend_);
+
+  registers_.assign(program_.registerCount, 0.f);
+  for (const auto &constant : program_.constants) {
+    registers_[constant.target] = constant.value;
+  }
+  loadParams(resolveParameters(program_, params_));
+}
+
+void BytecodeInterpreter::loadParams(const std::vector<float> &values) {
+  for (size_t i = 0; i < values.size(); i++) {
+    registers_[program_.parameters[i].target] = values[i];
+  }
+}
+
+Particle BytecodeInterpreter::randomizeParticle() {
+  Particle particle;
+  randomizeParticle(*rng_, particle);
+  particle.ttl = (ttl_ == Particle::IMMORTAL) ? Particle::IMMORTAL
+                                              : rng_->randomInt(1, ttl_);
+  return particle;
+}
+
+template <typename Generator>
+void BytecodeInterpreter::randomizeParticle(Generator &rng,
+                                            Particle &particle) {
+  particle.point =
+      Point(rng.randomFloat(-1.f, 1.f), rng.randomFloat(-1.f, 1.f));
+  particle.color = rng.randomFloat(0.f, 1.f);
+}
+
+void BytecodeInterpreter::setSystem(const ast::System &system) {
+  setSystem(system, params_);
+}
+
+void BytecodeInterpreter::setSystem(const ast::System &system, Params params) {
+  Program program = compile(system);
+  resolveParameters(program, params);
+
+  program_ = std::move(program);
+  params_ = std::move(params);
+  loadProgram();
+}
+
+void BytecodeInterpreter::setParams(Params params) {
+  loadParams(resolveParameters(program_, params));
+  params_ = std::move(params);
+}
+
+void BytecodeInterpreter::setTtl(int ttl) { ttl_ = ttl; }
+
+void BytecodeInterpreter::setBackend(ExecutionBackend backend) {
+  requestedBackend_ = backend;
+  native_ = (backend == +ExecutionBackend::Jit) ? jitCompile(program_)
+                                                : nullptr;
+}
+
+Particle BytecodeInterpreter::run(const BlendCode &blend,
+                                  NativeProgram::BlendFunction native,
+                                  const Particle &input) {
+  float *r = registers_.data();
+  r[Program::INPUT_X] = input.x();
+  r[Program::INPUT_Y] = input.y();
+  r[Program::INPUT_COLOR] = input.color;
+
+  if (native) {
+    native(r);
+  } else {
+    const Instruction *code = program_.code.data();
+    execute(code + blend.begin, code + blend.end, r);
+  }
+
+  return {Point(r[blend.x], r[blend.y]), r[blend.color], input.ttl};
+}
+
+BytecodeInterpreter::Result BytecodeInterpreter::operator()(Particle input) {
+  return step(*rng_, input);
+}
+
+void BytecodeInterpreter::iterate(Particle &particle, Particle *outputs,
+                                  size_t count) {
+  visitRng(*rng_, [&](auto &rng) {
+    for (size_t i = 0; i < count; i++) {
+      auto [next_state, output] = step(rng, particle);
+      particle = next_state;
+      outputs[i] = output;
+    }
+  });
+}
+
+template <typename Generator>
+BytecodeInterpreter::Result BytecodeInterpreter::step(Generator &rng,
+                                                      Particle input) {
+  Particle next_state = input;
+
+  if (next_state.ttl == 0) {
+    randomizeParticle(rng, next_state);
+    next_state.ttl = ttl_;
+  }
+
+  if (!program_.blends.empty()) {
+    size_t blend_index = blendTable_.sample(rng);
+    next_state = run(program_.blends[blend_index],
+                     native_ ? native_->blend(blend_index) : nullptr,
+                     next_state);
+  }
+
+  if (next_state.ttl != Particle::IMMORTAL) {
+    --next_state.ttl;
+  }
+
+  Particle output =
+      run(program_.finalBlend, native_ ? native_->finalBlend() : nullptr,
+          next_state);
+
+  return {next_state, output};
+}
+
+}  // namespace chaoskit::core
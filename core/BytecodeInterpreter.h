@@ -0,0 +1,83 @@
+#ifndef CHAOSKIT_CORE_BYTECODEINTERPRETER_H
+#define CHAOSKIT_CORE_BYTECODEINTERPRETER_H
+
+#include <ast/System.h>
+#include <enum.h>
+#include <vector>
+#include "AliasTable.h"
+#include "Bytecode.h"
+#include "Jit.h"
+#include "Params.h"
+#include "Particle.h"
+#include "Rng.h"
+#include "SimpleInterpreter.h"
+
+namespace chaoskit::core {
+
+BETTER_ENUM(ExecutionBackend, int, Interpreter, Jit)
+
+/**
+ * Drop-in replacement for SimpleInterpreter that compiles the system to
+ * bytecode once instead of walking the AST on every iteration. Given the same
+ * RNG stream, both produce the same results.
+ *
+ * Missing parameters are reported by throwing MissingParameterError as soon
+ * as a system or parameters are set, never while iterating.
+ *
+ * With the JIT backend, blends run as native code instead. Platforms without
+ * JIT support keep interpreting the bytecode.
+ */
+class BytecodeInterpreter {
+ public:
+  using Result = SimpleInterpreter::Result;
+
+  explicit BytecodeInterpreter(const ast::System &system,
+                               int ttl = Particle::IMMORTAL,
+                               Params params = Params{});
+  BytecodeInterpreter(const ast::System &system, int ttl, Params params,
+                      std::shared_ptr<Rng> rng);
+
+  void setSystem(const ast::System &system);
+  void setSystem(const ast::System &system, Params params);
+  void setParams(Params params);
+  void setTtl(int ttl);
+  void setBackend(ExecutionBackend backend);
+  Particle randomizeParticle();
+  Result operator()(Particle input);
+  /**
+   * Same as calling operator() `count` times from `particle`, writing the
+   * outputs to `outputs` and leaving `particle` at the last state, but binds
+   * the Rng to its concrete type only once (see visitRng()).
+   */
+  void iterate(Particle &particle, Particle *outputs, size_t count);
+
+  [[nodiscard]] const Program &program() const { return program_; }
+
+  /** The backend actually in use, which may differ from the requested one. */
+  [[nodiscard]] ExecutionBackend backend() const {
+    return native_ ? ExecutionBackend::Jit : ExecutionBackend::Interpreter;
+  }
+
+ private:
+  Program program_;
+  int ttl_;
+  Params params_;
+  AliasTable blendTable_;
+  std::shared_ptr<Rng> rng_;
+  ExecutionBackend requestedBackend_ = ExecutionBackend::Interpreter;
+  std::shared_ptr<const NativeProgram> native_;
+  std::vector<float> registers_;
+
+  void loadProgram();
+  void loadParams(const std::vector<float> &values);
+  template <typename Generator>
+  void randomizeParticle(Generator &rng, Particle &particle);
+  template <typename Generator>
+  Result step(Generator &rng, Particle input);
+  Particle run(const BlendCode &blend, NativeProgram::BlendFunction native,
+               const Particle &input);
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_BYTECODEINTERPRETER_H
@@ -0,0 +1,142 @@
+#include <gmock/gmock.h>
+
+#include <random>
+#include "BytecodeInterpreter.h"
+#include "FastRng.h"
+#include "SimpleInterpreter.h"
+#include "ast/helpers.h"
+#include "core/errors.h"
+#include "library/DeJong.h"
+#include "library/Drain.h"
+#include "library/coloring_methods/Distance.h"
+
+namespace chaoskit::core {
+
+using ast::helpers::make_system;
+using testing::Eq;
+
+class BytecodeInterpreterTest : public testing::Test {};
+
+/** Deterministic RNG, so that two interpreters can see the same stream. */
+class SeededRng : public Rng {
+ public:
+  explicit SeededRng(uint32_t seed) : engine_(seed) {}
+
+  float randomFloat(float min, float max) override {
+    return std::uniform_real_distribution<float>(min, max)(engine_);
+  }
+  int randomInt(int min, int max) override {
+    return std::uniform_int_distribution<int>(min, max)(engine_);
+  }
+
+ private:
+  std::mt19937 engine_;
+};
+
+ast::System make_complex_system() {
+  using namespace ast::helpers;
+  ast::Transform pre(.9f, -.1f, .05f, .1f, .9f, -.05f);
+  ast::Transform post(1.1f, 0.f, 0.f, 0.f, .8f, .1f);
+
+  ast::Blend dejong({ast::WeightedFormula(library::DeJong().source(), .7f, .6f),
+                     ast::WeightedFormula(library::Drain().source(), .3f, .4f)},
+                    pre, post, library::coloring_methods::Distance().source());
+  ast::Blend drain({ast::WeightedFormula(library::Drain().source())}, post, pre,
+                   plus(signum(OutputHelper().x()) * .5f, .5f));
+  ast::Blend final_blend({}, ast::Transform::identity(), post);
+
+  return ast::System{
+      {ast::LimitedBlend(dejong, 1.f), ast::LimitedBlend(drain, 1.5f)},
+      final_blend};
+}
+
+Params make_complex_params() {
+  Params params;
+  params[SystemIndex{0, 0}] = {1.4f, -2.3f, 2.4f, -2.1f};
+  params[SystemIndex{0, 1}] = {.7f, -.5f, .3f, 0.f};
+  params[SystemIndex{0, SystemIndex::COLORING_METHOD}] = {.2f};
+  params[SystemIndex{1, 0}] = {.2f, .9f, -.3f, .1f};
+  return params;
+}
+
+TEST_F(BytecodeInterpreterTest, EmptySystem) {
+  ast::System system{};
+  Particle input{{0.f, 0.f}, .5f, Particle::IMMORTAL};
+
+  BytecodeInterpreter interpreter(system);
+
+  ASSERT_THAT(interpreter(input),
+              Eq(BytecodeInterpreter::Result{input, input}));
+}
+
+TEST_F(BytecodeInterpreterTest, InterpretsFormula) {
+  Particle input{{0.f, 0.f}, .5f, Particle::IMMORTAL};
+  ast::Formula formula{1.f, 2.f};
+
+  BytecodeInterpreter interpreter(make_system(formula));
+
+  Particle output{{1.f, 2.f}, .5f, Particle::IMMORTAL};
+  ASSERT_THAT(interpreter(input),
+              Eq(BytecodeInterpreter::Result{output, output}));
+}
+
+TEST_F(BytecodeInterpreterTest, DecrementsTtl) {
+  ast::System system{};
+  Particle input{{0.f, 0.f}, .5f, 5};
+
+  BytecodeInterpreter interpreter(system);
+
+  Particle output{{0.f, 0.f}, .5f, 4};
+  ASSERT_THAT(interpreter(input),
+              Eq(BytecodeInterpreter::Result{output, output}));
+}
+
+TEST_F(BytecodeInterpreterTest, ThrowsOnMissingParameter) {
+  using namespace ast::helpers;
+  ParameterHelper params;
+  auto system = make_system(ast::Formula{params[0], params[1]});
+
+  ASSERT_THROW(BytecodeInterpreter{system}, MissingParameterError);
+}
+
+TEST_F(BytecodeInterpreterTest, MatchesSimpleInterpreter) {
+  auto system = make_complex_system();
+  auto params = make_complex_params();
+  SimpleInterpreter simple(system, 20, params, std::make_shared<SeededRng>(1));
+  BytecodeInterpreter bytecode(system, 20, params,
+                               std::make_shared<SeededRng>(1));
+
+  auto simpleParticle = simple.randomizeParticle();
+  auto bytecodeParticle = bytecode.randomizeParticle();
+  ASSERT_THAT(bytecodeParticle, Eq(simpleParticle));
+
+  for (int i = 0; i < 10000; i++) {
+    auto expected = simple(simpleParticle);
+    auto actual = bytecode(bytecodeParticle);
+    ASSERT_THAT(actual, Eq(expected)) << "at iteration " << i;
+    simpleParticle = expected.next_state;
+    bytecodeParticle = actual.next_state;
+  }
+}
+
+TEST_F(BytecodeInterpreterTest, IteratesLikeRepeatedCalls) {
+  auto system = make_complex_system();
+  auto params = make_complex_params();
+  BytecodeInterpreter called(system, 20, params, std::make_shared<FastRng>(1));
+  BytecodeInterpreter iterated(system, 20, params,
+                               std::make_shared<FastRng>(1));
+  Particle calledParticle = called.randomizeParticle();
+  Particle iteratedParticle = iterated.randomizeParticle();
+
+  std::vector<Particle> outputs(1000);
+  iterated.iterate(iteratedParticle, outputs.data(), outputs.size());
+
+  for (size_t i = 0; i < outputs.size(); i++) {
+    auto expected = called(calledParticle);
+    ASSERT_THAT(outputs[i], Eq(expected.output)) << "at iteration " << i;
+    calledParticle = expected.next_state;
+  }
+  ASSERT_THAT(iteratedParticle, Eq(calledParticle));
+}
+
+}  // namespace chaoskit::core
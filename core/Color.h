@@ -17,6 +17,13 @@ struct Color {
     a += other.a;
     return *this;
   }
+  Color& operator*=(float factor) {
+    r *= factor;
+    g *= factor;
+    b *= factor;
+    a *= factor;
+    return *this;
+  }
 
   static Color zero() { return Color{0.f, 0.f, 0.f, 0.f}; }
 };
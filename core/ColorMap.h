@@ -1,6 +1,7 @@
 #ifndef CHAOSKIT_CORE_COLORMAP_H
 #define CHAOSKIT_CORE_COLORMAP_H
 
+#include <cstddef>
 #include "Color.h"
 
 namespace chaoskit::core {
@@ -9,6 +10,14 @@ class ColorMap {
  public:
   virtual ~ColorMap() = default;
   [[nodiscard]] virtual Color map(float color) const = 0;
+
+  /** Maps `count` colors at once, for callers that have many to map. */
+  virtual void mapMany(const float *colors, size_t count,
+                       Color *output) const {
+    for (size_t i = 0; i < count; i++) {
+      output[i] = map(colors[i]);
+    }
+  }
 };
 
 }  // namespace chaoskit::core
@@ -5,22 +5,27 @@
 
 namespace chaoskit::core {
 
-ColorMapRegistry::ColorMapRegistry() : colorMaps_() {
-  add("BlackWhite", std::make_unique<BlackWhiteColorMap>());
-  add("Rainbow", std::make_unique<RainbowColorMap>());
+ColorMapRegistry::ColorMapRegistry(size_t lookupSize)
+    : lookupSize_(lookupSize), colorMaps_() {
+  add("BlackWhite", BlackWhiteColorMap());
+  add("Rainbow", RainbowColorMap());
 }
 
-void ColorMapRegistry::add(std::string name,
-                           std::unique_ptr<ColorMap> colorMap) {
+void ColorMapRegistry::add(std::string name, const ColorMap& colorMap) {
   auto [_, ok] = names_.insert(name);
   if (ok) {
-    colorMaps_.emplace(std::move(name), std::move(colorMap));
+    colorMaps_.emplace(std::move(name), LookupColorMap(colorMap, lookupSize_));
   }
 }
 
+void ColorMapRegistry::add(std::string name,
+                           std::unique_ptr<ColorMap> colorMap) {
+  add(std::move(name), *colorMap);
+}
+
 const ColorMap* ColorMapRegistry::get(const std::string& name) const {
   try {
-    return colorMaps_.at(name).get();
+    return &colorMaps_.at(name);
   } catch (std::out_of_range& e) {
     throw InvalidColorMap(name);
   }
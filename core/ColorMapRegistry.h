@@ -5,18 +5,25 @@
 #include <string>
 #include <unordered_map>
 #include "ColorMap.h"
+#include "LookupColorMap.h"
 
 namespace chaoskit::core {
 
+/**
+ * Named color maps, each baked into a LookupColorMap of `lookupSize` entries
+ * when added, so that user-defined maps cost the same as built-in ones.
+ */
 class ColorMapRegistry {
  public:
-  ColorMapRegistry();
+  explicit ColorMapRegistry(size_t lookupSize = LookupColorMap::DEFAULT_SIZE);
+  void add(std::string name, const ColorMap& colorMap);
   void add(std::string name, std::unique_ptr<ColorMap> colorMap);
   [[nodiscard]] const ColorMap* get(const std::string& name) const;
   [[nodiscard]] const std::set<std::string>& names() const { return names_; }
 
  private:
-  std::unordered_map<std::string, std::unique_ptr<ColorMap>> colorMaps_;
+  size_t lookupSize_;
+  std::unordered_map<std::string, LookupColorMap> colorMaps_;
   std::set<std::string> names_;
 };
 
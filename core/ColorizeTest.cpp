@@ -0,0 +1,44 @@
+#include <gmock/gmock.h>
+
+#include "BlackWhiteColorMap.h"
+#include "colorize.h"
+
+namespace chaoskit::core {
+
+using testing::FloatEq;
+
+class ColorizeTest : public testing::Test {};
+
+TEST_F(ColorizeTest, LeavesEmptyBinsBlack) {
+  Color color = colorize(Bin{}, nullptr);
+
+  ASSERT_THAT(color.r, FloatEq(0.f));
+  ASSERT_THAT(color.a, FloatEq(0.f));
+}
+
+TEST_F(ColorizeTest, ScalesWhiteByDensityWithoutColorMap) {
+  Color color = colorize(Bin{3.f, 1.5f}, nullptr);
+
+  ASSERT_THAT(color.r, FloatEq(3.f));
+  ASSERT_THAT(color.b, FloatEq(3.f));
+  ASSERT_THAT(color.a, FloatEq(3.f));
+}
+
+TEST_F(ColorizeTest, MapsAverageColor) {
+  BlackWhiteColorMap colorMap;
+
+  Color color = colorize(Bin{4.f, 1.f}, &colorMap);
+
+  ASSERT_THAT(color.g, FloatEq(1.f));
+  ASSERT_THAT(color.a, FloatEq(4.f));
+}
+
+TEST_F(ColorizeTest, ClampsAverageColor) {
+  BlackWhiteColorMap colorMap;
+
+  Color color = colorize(Bin{2.f, 6.f}, &colorMap);
+
+  ASSERT_THAT(color.r, FloatEq(2.f));
+}
+
+}  // namespace chaoskit::core
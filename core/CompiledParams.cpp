@@ -0,0 +1,93 @@
+#include "CompiledParams.h"
+
+#include <set>
+#include <stdexcept>
+#include "ast/ast.h"
+#include "errors.h"
+
+namespace chaoskit::core {
+
+using ast::apply_visitor;
+
+namespace {
+
+/** Collects the indices of all parameters read by an expression. */
+class ParameterCollector {
+ public:
+  explicit ParameterCollector(std::set<size_t> &indices) : indices_(indices) {}
+
+  void operator()(const ast::Parameter &parameter) const {
+    indices_.insert(parameter.index());
+  }
+  void operator()(const ast::UnaryFunction &function) const {
+    apply_visitor(*this, function.argument());
+  }
+  void operator()(const ast::BinaryFunction &function) const {
+    apply_visitor(*this, function.first());
+    apply_visitor(*this, function.second());
+  }
+
+  template <typename T>
+  void operator()(const T &) const {}
+
+ private:
+  std::set<size_t> &indices_;
+};
+
+}  // namespace
+
+CompiledParams::CompiledParams(const ast::System &system,
+                               const Params &params) {
+  for (size_t i = 0; i < system.blends().size(); i++) {
+    blends_.push_back(layout(system.blends()[i].blend(), i, params));
+  }
+  finalBlend_ =
+      layout(system.final_blend(), SystemIndex::FINAL_BLEND, params);
+}
+
+CompiledParams::BlendOffsets CompiledParams::layout(const ast::Blend &blend,
+                                                    size_t blendIndex,
+                                                    const Params &params) {
+  BlendOffsets offsets;
+  SystemIndex index{blendIndex, 0};
+  for (const auto &formula : blend.formulas()) {
+    offsets.formulas.push_back(layout(
+        index, {&formula.formula().x(), &formula.formula().y()}, params));
+    index.formula++;
+  }
+
+  index.formula = SystemIndex::COLORING_METHOD;
+  offsets.coloringMethod = layout(index, {&blend.coloringMethod()}, params);
+  return offsets;
+}
+
+uint32_t CompiledParams::layout(
+    const SystemIndex &index,
+    std::initializer_list<const ast::Expression *> expressions,
+    const Params &params) {
+  std::set<size_t> indices;
+  for (const auto *expression : expressions) {
+    apply_visitor(ParameterCollector(indices), *expression);
+  }
+
+  auto offset = static_cast<uint32_t>(values_.size());
+  if (indices.empty()) {
+    return offset;
+  }
+
+  const std::vector<float> *values = nullptr;
+  try {
+    values = &params.at(index);
+  } catch (std::out_of_range &e) {
+    throw MissingParameterError(index, *indices.begin());
+  }
+  size_t last = *indices.rbegin();
+  if (last >= values->size()) {
+    throw MissingParameterError(index, *indices.lower_bound(values->size()));
+  }
+
+  values_.insert(values_.end(), values->begin(), values->begin() + last + 1);
+  return offset;
+}
+
+}  // namespace chaoskit::core
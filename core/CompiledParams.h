@@ -0,0 +1,57 @@
+#ifndef CHAOSKIT_CORE_COMPILEDPARAMS_H
+#define CHAOSKIT_CORE_COMPILEDPARAMS_H
+
+#include <ast/System.h>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include "Params.h"
+#include "SystemIndex.h"
+
+namespace chaoskit::core {
+
+/**
+ * Params laid out for one system: values of all formulas and coloring
+ * methods are stored in a single buffer, and each of them knows where its
+ * values start, so reading a parameter is a plain array access.
+ *
+ * Construction checks every parameter the system reads and throws
+ * MissingParameterError for the first one that has no value, so that
+ * evaluation itself never has to.
+ */
+class CompiledParams {
+ public:
+  CompiledParams() = default;
+  CompiledParams(const ast::System &system, const Params &params);
+
+  /** Values of the formula or coloring method at the given index. */
+  [[nodiscard]] const float *at(const SystemIndex &index) const {
+    const auto &blend = (index.blend == SystemIndex::FINAL_BLEND)
+                            ? finalBlend_
+                            : blends_[index.blend];
+    uint32_t offset = (index.formula == SystemIndex::COLORING_METHOD)
+                          ? blend.coloringMethod
+                          : blend.formulas[index.formula];
+    return values_.data() + offset;
+  }
+
+ private:
+  struct BlendOffsets {
+    std::vector<uint32_t> formulas;
+    uint32_t coloringMethod = 0;
+  };
+
+  std::vector<float> values_;
+  std::vector<BlendOffsets> blends_;
+  BlendOffsets finalBlend_;
+
+  BlendOffsets layout(const ast::Blend &blend, size_t blendIndex,
+                      const Params &params);
+  uint32_t layout(const SystemIndex &index,
+                  std::initializer_list<const ast::Expression *> expressions,
+                  const Params &params);
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_COMPILEDPARAMS_H
@@ -0,0 +1,67 @@
+#include <gmock/gmock.h>
+
+#include "CompiledParams.h"
+#include "ast/helpers.h"
+#include "core/errors.h"
+
+namespace chaoskit::core {
+
+using ast::helpers::make_system;
+using ast::helpers::ParameterHelper;
+using testing::ElementsAre;
+
+class CompiledParamsTest : public testing::Test {};
+
+std::vector<float> read(const CompiledParams &params, const SystemIndex &index,
+                        size_t count) {
+  const float *values = params.at(index);
+  return std::vector<float>(values, values + count);
+}
+
+TEST_F(CompiledParamsTest, LaysOutFormulaParameters) {
+  ParameterHelper p;
+  ast::Blend blend{{ast::WeightedFormula(ast::Formula{p[0], p[1]}),
+                    ast::WeightedFormula(ast::Formula{p[1], 0.f})},
+                   {},
+                   {},
+                   p[0]};
+  ast::System system{{ast::LimitedBlend(blend, 1.f)}};
+  Params params;
+  params[SystemIndex{0, 0}] = {1.f, 2.f};
+  params[SystemIndex{0, 1}] = {3.f, 4.f};
+  params[SystemIndex{0, SystemIndex::COLORING_METHOD}] = {5.f};
+
+  CompiledParams compiled(system, params);
+
+  EXPECT_THAT(read(compiled, SystemIndex{0, 0}, 2), ElementsAre(1.f, 2.f));
+  EXPECT_THAT(read(compiled, SystemIndex{0, 1}, 2), ElementsAre(3.f, 4.f));
+  EXPECT_THAT(
+      read(compiled, SystemIndex{0, SystemIndex::COLORING_METHOD}, 1),
+      ElementsAre(5.f));
+}
+
+TEST_F(CompiledParamsTest, IgnoresUnusedParams) {
+  ast::System system = make_system(ast::Formula{1.f, 2.f});
+  Params params;
+  params[SystemIndex{3, 0}] = {1.f};
+
+  ASSERT_NO_THROW(CompiledParams(system, params));
+}
+
+TEST_F(CompiledParamsTest, ThrowsOnMissingFormula) {
+  ParameterHelper p;
+  ast::System system = make_system(ast::Formula{p[0], 0.f});
+
+  ASSERT_THROW(CompiledParams(system, Params{}), MissingParameterError);
+}
+
+TEST_F(CompiledParamsTest, ThrowsOnMissingIndex) {
+  ParameterHelper p;
+  ast::System system = make_system(ast::Formula{p[0], p[2]});
+  Params params;
+  params[SystemIndex{0, 0}] = {1.f, 2.f};
+
+  ASSERT_THROW(CompiledParams(system, params), MissingParameterError);
+}
+
+}  // namespace chaoskit::core
@@ -0,0 +1,204 @@
+#include "ConcurrentHistogram.h"
+
+namespace chaoskit::core {
+
+namespace {
+
+uint64_t packSize(size_t width, size_t height) {
+  return (static_cast<uint64_t>(width) << 32) | static_cast<uint32_t>(height);
+}
+
+size_t unpackWidth(uint64_t size) { return static_cast<size_t>(size >> 32); }
+size_t unpackHeight(uint64_t size) {
+  return static_cast<size_t>(static_cast<uint32_t>(size));
+}
+
+/**
+ * Batches are stamped with their own version and clean below it, so this
+ * leaves no tile of an empty batch marked as changed.
+ */
+void markClean(HistogramBuffer &batch) {
+  batch.setVersion(batch.version() + 1);
+}
+
+/** Resampling by `first`, then by `second`, in one step. */
+HistogramBuffer::Resampling chain(const HistogramBuffer::Resampling &first,
+                                  const HistogramBuffer::Resampling &second) {
+  HistogramBuffer::Resampling result;
+  result.ratioX = first.ratioX * second.ratioX;
+  result.ratioY = first.ratioY * second.ratioY;
+  result.offsetX = second.offsetX * first.ratioX + first.offsetX;
+  result.offsetY = second.offsetY * first.ratioY + first.offsetY;
+  result.gain = first.gain * second.gain;
+  return result;
+}
+
+}  // namespace
+
+ConcurrentHistogram::Writer::Writer(ConcurrentHistogram &histogram)
+    : histogram_(histogram),
+      active_(0, 0, histogram.layout_),
+      generation_(histogram.generation_.load(std::memory_order_acquire)),
+      pending_(0, 0, histogram.layout_) {
+  resizeActive();
+}
+
+void ConcurrentHistogram::Writer::resizeActive() {
+  uint64_t size = histogram_.size_.load(std::memory_order_acquire);
+  size_t width = unpackWidth(size);
+  size_t height = unpackHeight(size);
+  if (active_.width() != width || active_.height() != height) {
+    active_.resize(width, height);
+    markClean(active_);
+  }
+}
+
+void ConcurrentHistogram::Writer::flush() {
+  uint64_t generation = histogram_.generation_.load(std::memory_order_acquire);
+  if (generation != generation_) {
+    active_.clear();
+    markClean(active_);
+    resizeActive();
+    generation_ = generation;
+    dirty_ = false;
+  }
+  if (!dirty_) {
+    return;
+  }
+
+  std::unique_lock lock(mutex_, std::try_to_lock);
+  if (!lock || pending_filled_) {
+    return;
+  }
+  std::swap(active_, pending_);
+  pending_generation_ = generation_;
+  pending_filled_ = true;
+  lock.unlock();
+
+  // The reader hands back clean buffers, but maybe not of the current size.
+  dirty_ = false;
+  resizeActive();
+}
+
+ConcurrentHistogram::ConcurrentHistogram(size_t width, size_t height,
+                                         HistogramBuffer::Layout layout)
+    : layout_(layout),
+      spare_(width, height, layout),
+      width_(width),
+      height_(height),
+      size_(packSize(width, height)) {
+  for (auto &snapshot : snapshots_) {
+    snapshot = HistogramBuffer(width, height, layout);
+  }
+  markClean(spare_);
+}
+
+ConcurrentHistogram::Writer &ConcurrentHistogram::addWriter() {
+  std::lock_guard lock(writers_mutex_);
+  writers_.push_back(std::unique_ptr<Writer>(new Writer(*this)));
+  return *writers_.back();
+}
+
+void ConcurrentHistogram::clear() {
+  start_empty_ = true;
+  resampling_ = stdx::nullopt;
+  generation_.fetch_add(1, std::memory_order_release);
+}
+
+void ConcurrentHistogram::resize(size_t width, size_t height) {
+  start_empty_ = true;
+  resampling_ = stdx::nullopt;
+  applySize(width, height);
+}
+
+void ConcurrentHistogram::resize(
+    size_t width, size_t height,
+    const HistogramBuffer::Resampling &resampling) {
+  // A histogram that's going to be empty stays empty.
+  if (!start_empty_) {
+    resampling_ = resampling_ ? chain(*resampling_, resampling) : resampling;
+  }
+  applySize(width, height);
+}
+
+void ConcurrentHistogram::applySize(size_t width, size_t height) {
+  width_ = width;
+  height_ = height;
+  spare_.resize(width, height);
+  markClean(spare_);
+  size_.store(packSize(width, height), std::memory_order_release);
+  generation_.fetch_add(1, std::memory_order_release);
+}
+
+void ConcurrentHistogram::decay(float factor) { decay_ *= factor; }
+
+void ConcurrentHistogram::publish() {
+  HistogramBuffer &back = snapshots_[back_];
+  const HistogramBuffer &published = snapshots_[published_];
+  uint64_t version = published.version() + 1;
+
+  if (start_empty_) {
+    back.setVersion(version);
+    if (back.width() != width_ || back.height() != height_) {
+      back.resize(width_, height_);
+    } else {
+      back.clear();
+    }
+    start_empty_ = false;
+  } else if (resampling_) {
+    back.setVersion(version);
+    back.resize(width_, height_);
+    back.resampleFrom(published, *resampling_);
+    resampling_ = stdx::nullopt;
+  } else {
+    // Every snapshot is derived from the previous one, so the back buffer
+    // only misses the tiles that changed after it was published. Nobody
+    // writes to published snapshots, even if a reader holds this one.
+    back.copyChanged(published, back.version());
+    back.setVersion(version);
+  }
+  if (decay_ != 1.f) {
+    back.scale(decay_);
+  }
+  decay_ = 1.f;
+  // Tiles left stale by clear() are only zeroed once written to, readers
+  // read them as zero anyway.
+  collect(back);
+
+  published_ = back_;
+  published_version_.store(version, std::memory_order_relaxed);
+  back_ = static_cast<uint8_t>(
+      latest_.exchange(back_ | FRESH, std::memory_order_acq_rel) & ~FRESH);
+}
+
+void ConcurrentHistogram::collect(HistogramBuffer &target) {
+  uint64_t generation = generation_.load(std::memory_order_relaxed);
+
+  std::lock_guard writersLock(writers_mutex_);
+  for (auto &writer : writers_) {
+    uint64_t pendingGeneration;
+    {
+      std::lock_guard lock(writer->mutex_);
+      if (!writer->pending_filled_) {
+        continue;
+      }
+      std::swap(writer->pending_, spare_);
+      pendingGeneration = writer->pending_generation_;
+      writer->pending_filled_ = false;
+    }
+
+    uint64_t since = spare_.version() - 1;
+    if (pendingGeneration == generation) {
+      target.addChanged(spare_, since);
+    }
+
+    if (spare_.width() != width_ || spare_.height() != height_) {
+      spare_.resize(width_, height_);
+    } else {
+      spare_.clearChanged(since);
+    }
+    markClean(spare_);
+  }
+}
+
+}  // namespace chaoskit::core
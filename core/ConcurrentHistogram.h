@@ -0,0 +1,164 @@
+#ifndef CHAOSKIT_CORE_CONCURRENTHISTOGRAM_H
+#define CHAOSKIT_CORE_CONCURRENTHISTOGRAM_H
+
+#include <stdx/optional.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "HistogramBuffer.h"
+
+namespace chaoskit::core {
+
+/**
+ * A histogram fed by any number of writer threads, owned by one thread that
+ * publishes snapshots of it, and read by others, where nobody waits for the
+ * readers.
+ *
+ * Each writer adds to a private buffer and, on flush(), hands it over in
+ * exchange for a clean one. The owner adds the buffers it was handed to the
+ * next snapshot on publish(). Snapshots are triple-buffered: the owner fills
+ * one while readers hold another, and the third one is the latest published,
+ * so a reader always sees a complete snapshot and never holds anyone up.
+ * Snapshots may hold tiles left stale by clear(), which readers must take as
+ * zero, see HistogramBuffer::isStale().
+ *
+ * clear(), resize(), decay() and publish() must only be called from the
+ * owning thread.
+ * Writers notice clear() and resize() on their next flush() and drop
+ * whatever they held.
+ */
+class ConcurrentHistogram {
+ public:
+  class Writer {
+   public:
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    /** Adds to a pixel. Pixels out of bounds are ignored. */
+    void add(size_t x, size_t y, const Bin &bin) {
+      if (x < active_.width() && y < active_.height()) {
+        active_.add(x, y, bin);
+        dirty_ = true;
+      }
+    }
+
+    /** Size of the buffer added to, as of the last flush(). */
+    [[nodiscard]] size_t width() const { return active_.width(); }
+    [[nodiscard]] size_t height() const { return active_.height(); }
+
+    /**
+     * Hands over what was added so far, unless the owner didn't take the
+     * previous batch yet, in which case it stays here until the next call.
+     * Never blocks.
+     */
+    void flush();
+
+   private:
+    friend class ConcurrentHistogram;
+
+    explicit Writer(ConcurrentHistogram &histogram);
+
+    ConcurrentHistogram &histogram_;
+    HistogramBuffer active_;
+    uint64_t generation_;
+    bool dirty_ = false;
+
+    // Shared with the owner.
+    std::mutex mutex_;
+    HistogramBuffer pending_;
+    uint64_t pending_generation_ = 0;
+    bool pending_filled_ = false;
+
+    void resizeActive();
+  };
+
+  /** All buffers, including snapshots, are stored with `layout`. */
+  explicit ConcurrentHistogram(
+      size_t width = 0, size_t height = 0,
+      HistogramBuffer::Layout layout = HistogramBuffer::Layout::Linear);
+
+  /**
+   * Creates a writer to be used from a single thread at a time. It lives as
+   * long as the histogram.
+   */
+  Writer &addWriter();
+
+  void clear();
+  void resize(size_t width, size_t height);
+  /**
+   * Resizes the histogram keeping what it holds, resampled as described by
+   * `resampling`. Batches writers hold are still dropped.
+   */
+  void resize(size_t width, size_t height,
+              const HistogramBuffer::Resampling &resampling);
+  /**
+   * Multiplies the histogram by `factor` on the next publish(), so that what
+   * was gathered so far fades out instead of disappearing at once.
+   */
+  void decay(float factor);
+
+  /** Makes everything handed over by the writers visible to readers. */
+  void publish();
+
+  /** Version of the latest published snapshot. Safe from any thread. */
+  [[nodiscard]] uint64_t publishedVersion() const {
+    return published_version_.load(std::memory_order_relaxed);
+  }
+
+  /** Whether the latest snapshot wasn't taken by a reader yet. */
+  [[nodiscard]] bool snapshotPending() const {
+    return (latest_.load(std::memory_order_relaxed) & FRESH) != 0;
+  }
+
+  /** Calls `action` with the latest published snapshot. */
+  template <typename Action>
+  void withSnapshot(Action action) {
+    std::lock_guard lock(reader_mutex_);
+    if (latest_.load(std::memory_order_relaxed) & FRESH) {
+      front_ = static_cast<uint8_t>(
+          latest_.exchange(front_, std::memory_order_acq_rel) & ~FRESH);
+    }
+    action(static_cast<const HistogramBuffer &>(snapshots_[front_]));
+  }
+
+ private:
+  /** Set in latest_ until a reader takes the snapshot. */
+  static constexpr uint8_t FRESH = 4;
+
+  std::mutex writers_mutex_;
+  std::vector<std::unique_ptr<Writer>> writers_;
+  HistogramBuffer::Layout layout_;
+  HistogramBuffer spare_;
+  size_t width_;
+  size_t height_;
+
+  /** Bumped by every clear() and resize(). */
+  std::atomic<uint64_t> generation_{0};
+  /** Width in the upper half, height in the lower one. */
+  std::atomic<uint64_t> size_;
+
+  std::array<HistogramBuffer, 3> snapshots_;
+  /** Index of the latest published snapshot, possibly with FRESH. */
+  std::atomic<uint8_t> latest_{1};
+  std::atomic<uint64_t> published_version_{1};
+  // Owned by the publishing thread.
+  uint8_t back_ = 2;
+  uint8_t published_ = 1;
+  bool start_empty_ = false;
+  float decay_ = 1.f;
+  /** How to turn the latest snapshot into the next one after resizing. */
+  stdx::optional<HistogramBuffer::Resampling> resampling_;
+  // Owned by readers.
+  std::mutex reader_mutex_;
+  uint8_t front_ = 0;
+
+  void applySize(size_t width, size_t height);
+  void collect(HistogramBuffer &target);
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_CONCURRENTHISTOGRAM_H
@@ -0,0 +1,363 @@
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+#include "ConcurrentHistogram.h"
+
+namespace chaoskit::core {
+
+using testing::Eq;
+using testing::FloatEq;
+
+class ConcurrentHistogramTest : public testing::Test {
+ protected:
+  static float densityAt(ConcurrentHistogram &histogram, size_t x, size_t y) {
+    histogram.publish();
+    return snapshotDensityAt(histogram, x, y);
+  }
+
+  static float snapshotDensityAt(ConcurrentHistogram &histogram, size_t x,
+                                 size_t y) {
+    float density = 0.f;
+    histogram.withSnapshot([&](const HistogramBuffer &buffer) {
+      std::vector<Bin> bins(buffer.size());
+      buffer.copyTo(bins.data());
+      density = bins[y * buffer.width() + x].density;
+    });
+    return density;
+  }
+};
+
+TEST_F(ConcurrentHistogramTest, StartsEmpty) {
+  ConcurrentHistogram histogram(2, 2);
+
+  ASSERT_THAT(densityAt(histogram, 1, 1), FloatEq(0.f));
+}
+
+TEST_F(ConcurrentHistogramTest, ShowsOnlyFlushedBins) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+
+  writer.add(1, 0, Bin{1.f, 0.f});
+  ASSERT_THAT(densityAt(histogram, 1, 0), FloatEq(0.f));
+
+  writer.flush();
+  ASSERT_THAT(densityAt(histogram, 1, 0), FloatEq(1.f));
+}
+
+TEST_F(ConcurrentHistogramTest, ShowsBinsOnlyOncePublished) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+
+  writer.add(1, 1, Bin{1.f, 0.f});
+  writer.flush();
+  ASSERT_THAT(snapshotDensityAt(histogram, 1, 1), FloatEq(0.f));
+
+  histogram.publish();
+  ASSERT_THAT(snapshotDensityAt(histogram, 1, 1), FloatEq(1.f));
+}
+
+TEST_F(ConcurrentHistogramTest, KeepsSnapshotPendingUntilTaken) {
+  ConcurrentHistogram histogram(2, 2);
+  ASSERT_FALSE(histogram.snapshotPending());
+
+  histogram.publish();
+  ASSERT_TRUE(histogram.snapshotPending());
+
+  snapshotDensityAt(histogram, 0, 0);
+  ASSERT_FALSE(histogram.snapshotPending());
+}
+
+TEST_F(ConcurrentHistogramTest, ReportsPublishedVersion) {
+  ConcurrentHistogram histogram(2, 2);
+  uint64_t initial = histogram.publishedVersion();
+
+  histogram.publish();
+  histogram.withSnapshot([&](const HistogramBuffer &buffer) {
+    ASSERT_THAT(buffer.version(), Eq(histogram.publishedVersion()));
+  });
+  ASSERT_THAT(histogram.publishedVersion(), testing::Gt(initial));
+}
+
+TEST_F(ConcurrentHistogramTest, AccumulatesAcrossSnapshots) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+
+  for (int i = 0; i < 5; i++) {
+    writer.add(0, 1, Bin{1.f, 0.f});
+    writer.flush();
+    histogram.publish();
+  }
+
+  ASSERT_THAT(snapshotDensityAt(histogram, 0, 1), FloatEq(5.f));
+}
+
+TEST_F(ConcurrentHistogramTest, ReaderKeepsItsSnapshotWhilePublishing) {
+  ConcurrentHistogram histogram(1, 1);
+  auto &writer = histogram.addWriter();
+
+  writer.add(0, 0, Bin{1.f, 0.f});
+  writer.flush();
+  histogram.publish();
+  histogram.withSnapshot([&](const HistogramBuffer &buffer) {
+    for (int i = 0; i < 3; i++) {
+      writer.add(0, 0, Bin{1.f, 0.f});
+      writer.flush();
+      histogram.publish();
+    }
+    ASSERT_THAT(buffer.data()->density, FloatEq(1.f));
+  });
+
+  ASSERT_THAT(snapshotDensityAt(histogram, 0, 0), FloatEq(4.f));
+}
+
+TEST_F(ConcurrentHistogramTest, ReportsTilesChangedBetweenSnapshots) {
+  constexpr size_t TILE = HistogramBuffer::TILE_SIZE;
+  ConcurrentHistogram histogram(2 * TILE, 2 * TILE);
+  auto &writer = histogram.addWriter();
+  uint64_t lastVersion = 0;
+  histogram.publish();
+  histogram.withSnapshot(
+      [&](const HistogramBuffer &buffer) { lastVersion = buffer.version(); });
+
+  writer.add(TILE, TILE, Bin{1.f, 0.f});
+  writer.flush();
+  histogram.publish();
+
+  histogram.withSnapshot([&](const HistogramBuffer &buffer) {
+    ASSERT_THAT(buffer.version(), testing::Gt(lastVersion));
+    std::vector<size_t> changed;
+    buffer.forEachChangedTile(
+        lastVersion, [&](const HistogramBuffer::Region &tile) {
+          changed.push_back(tile.x);
+          changed.push_back(tile.y);
+        });
+    ASSERT_THAT(changed, testing::ElementsAre(TILE, TILE));
+  });
+}
+
+TEST_F(ConcurrentHistogramTest, DecaysOnNextPublish) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+  writer.add(0, 0, Bin{4.f, 0.f});
+  writer.flush();
+  histogram.publish();
+
+  histogram.decay(0.5f);
+  writer.add(0, 0, Bin{1.f, 0.f});
+  writer.flush();
+
+  ASSERT_THAT(densityAt(histogram, 0, 0), FloatEq(3.f));
+  ASSERT_THAT(densityAt(histogram, 0, 0), FloatEq(3.f));
+}
+
+TEST_F(ConcurrentHistogramTest, KeepsBinsUntilReaderTakesPreviousBatch) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+
+  writer.add(0, 0, Bin{1.f, 0.f});
+  writer.flush();
+  writer.add(0, 0, Bin{2.f, 0.f});
+  writer.flush();
+  ASSERT_THAT(densityAt(histogram, 0, 0), FloatEq(1.f));
+
+  writer.flush();
+  ASSERT_THAT(densityAt(histogram, 0, 0), FloatEq(3.f));
+}
+
+TEST_F(ConcurrentHistogramTest, IgnoresPixelsOutOfBounds) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+
+  writer.add(2, 0, Bin{1.f, 0.f});
+  writer.add(0, 2, Bin{1.f, 0.f});
+  writer.flush();
+
+  histogram.publish();
+  histogram.withSnapshot([](const HistogramBuffer &buffer) {
+    for (size_t i = 0; i < buffer.size(); i++) {
+      ASSERT_THAT(buffer.data()[i].density, FloatEq(0.f));
+    }
+  });
+}
+
+TEST_F(ConcurrentHistogramTest, ClearDropsEverythingAddedBefore) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+
+  writer.add(0, 0, Bin{1.f, 0.f});
+  writer.flush();
+  ASSERT_THAT(densityAt(histogram, 0, 0), FloatEq(1.f));
+  writer.add(0, 0, Bin{1.f, 0.f});
+  writer.flush();
+
+  histogram.clear();
+  ASSERT_THAT(densityAt(histogram, 0, 0), FloatEq(0.f));
+
+  writer.add(0, 0, Bin{1.f, 0.f});
+  writer.flush();
+  writer.add(0, 0, Bin{4.f, 0.f});
+  writer.flush();
+  ASSERT_THAT(densityAt(histogram, 0, 0), FloatEq(4.f));
+}
+
+TEST_F(ConcurrentHistogramTest, PublishesClearedTilesWithoutZeroingThem) {
+  constexpr size_t TILE = HistogramBuffer::TILE_SIZE;
+  ConcurrentHistogram histogram(2 * TILE, TILE);
+  auto &writer = histogram.addWriter();
+  // Leaves something in both tiles of every snapshot.
+  for (int i = 0; i < 3; i++) {
+    writer.add(0, 0, Bin{1.f, 0.f});
+    writer.add(TILE, 0, Bin{1.f, 0.f});
+    writer.flush();
+    histogram.publish();
+  }
+
+  histogram.clear();
+  writer.flush();
+  writer.add(0, 0, Bin{4.f, 0.f});
+  writer.flush();
+  histogram.publish();
+
+  histogram.withSnapshot([&](const HistogramBuffer &buffer) {
+    ASSERT_FALSE(buffer.isStale({0, 0, TILE, TILE}));
+    ASSERT_THAT(buffer.pixel(0, 0)->density, FloatEq(4.f));
+    ASSERT_TRUE(buffer.isStale({TILE, 0, TILE, TILE}));
+    ASSERT_THAT(buffer.pixel(TILE, 0)->density, testing::Gt(0.f));
+
+    std::vector<Bin> bins(buffer.size());
+    buffer.copyTo(bins.data());
+    ASSERT_THAT(bins[TILE].density, FloatEq(0.f));
+  });
+}
+
+TEST_F(ConcurrentHistogramTest, WritersPickUpNewSizeOnFlush) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+
+  histogram.resize(3, 1);
+  ASSERT_THAT(writer.width(), Eq(2u));
+  histogram.publish();
+  histogram.withSnapshot([](const HistogramBuffer &buffer) {
+    ASSERT_THAT(buffer.width(), Eq(3u));
+  });
+
+  writer.flush();
+  ASSERT_THAT(writer.width(), Eq(3u));
+  ASSERT_THAT(writer.height(), Eq(1u));
+
+  writer.add(2, 0, Bin{1.f, 0.f});
+  writer.flush();
+  ASSERT_THAT(densityAt(histogram, 2, 0), FloatEq(1.f));
+}
+
+TEST_F(ConcurrentHistogramTest, ResamplesOnResize) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+  writer.add(1, 1, Bin{4.f, 0.f});
+  writer.flush();
+  histogram.publish();
+
+  HistogramBuffer::Resampling resampling;
+  resampling.ratioX = resampling.ratioY = 0.5f;
+  histogram.resize(4, 4, resampling);
+
+  ASSERT_THAT(densityAt(histogram, 2, 2), FloatEq(1.f));
+  ASSERT_THAT(densityAt(histogram, 3, 3), FloatEq(1.f));
+  ASSERT_THAT(densityAt(histogram, 1, 1), FloatEq(0.f));
+}
+
+TEST_F(ConcurrentHistogramTest, ChainsResamplingsBetweenPublishes) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+  writer.add(1, 1, Bin{4.f, 0.f});
+  writer.flush();
+  histogram.publish();
+
+  HistogramBuffer::Resampling up;
+  up.ratioX = up.ratioY = 0.5f;
+  up.gain = 0.25f;
+  histogram.resize(4, 4, up);
+  HistogramBuffer::Resampling shift;
+  shift.offsetX = 2.f;
+  histogram.resize(4, 4, shift);
+
+  ASSERT_THAT(densityAt(histogram, 0, 2), FloatEq(0.25f));
+  ASSERT_THAT(densityAt(histogram, 2, 2), FloatEq(0.f));
+}
+
+TEST_F(ConcurrentHistogramTest, StaysEmptyWhenResampledAfterClear) {
+  ConcurrentHistogram histogram(2, 2);
+  auto &writer = histogram.addWriter();
+  writer.add(1, 1, Bin{4.f, 0.f});
+  writer.flush();
+  histogram.publish();
+
+  histogram.clear();
+  HistogramBuffer::Resampling resampling;
+  resampling.ratioX = resampling.ratioY = 0.5f;
+  histogram.resize(4, 4, resampling);
+
+  ASSERT_THAT(densityAt(histogram, 2, 2), FloatEq(0.f));
+}
+
+TEST_F(ConcurrentHistogramTest, KeepsLayoutOfEveryBuffer) {
+  ConcurrentHistogram histogram(2, 2, HistogramBuffer::Layout::Tiled);
+  auto &writer = histogram.addWriter();
+  histogram.resize(3, 3);
+  writer.flush();
+
+  writer.add(2, 2, Bin{1.f, 0.f});
+  writer.flush();
+  histogram.publish();
+
+  histogram.withSnapshot([](const HistogramBuffer &buffer) {
+    ASSERT_THAT(buffer.layout(), Eq(HistogramBuffer::Layout::Tiled));
+    ASSERT_THAT(buffer.pixel(2, 2)->density, FloatEq(1.f));
+  });
+}
+
+TEST_F(ConcurrentHistogramTest, MergesConcurrentWriters) {
+  constexpr size_t WRITERS = 4;
+  constexpr int ADDS = 10000;
+  ConcurrentHistogram histogram(1, 1);
+
+  std::vector<ConcurrentHistogram::Writer *> writers;
+  for (size_t i = 0; i < WRITERS; i++) {
+    writers.push_back(&histogram.addWriter());
+  }
+  std::vector<std::thread> threads;
+  for (auto *writer : writers) {
+    threads.emplace_back([writer] {
+      for (int i = 0; i < ADDS; i++) {
+        writer->add(0, 0, Bin{1.f, 0.f});
+        if (i % 100 == 0) {
+          writer->flush();
+        }
+      }
+    });
+  }
+  threads.emplace_back([&histogram] {
+    for (int i = 0; i < 100; i++) {
+      snapshotDensityAt(histogram, 0, 0);
+    }
+  });
+  for (int i = 0; i < 100; i++) {
+    histogram.publish();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Each writer may need one more publish to hand over its last batch.
+  for (auto *writer : writers) {
+    writer->flush();
+  }
+  densityAt(histogram, 0, 0);
+  for (auto *writer : writers) {
+    writer->flush();
+  }
+  ASSERT_THAT(densityAt(histogram, 0, 0), FloatEq(WRITERS * ADDS));
+}
+
+}  // namespace chaoskit::core
@@ -0,0 +1,79 @@
+#include "CountingHistogram.h"
+
+namespace chaoskit::core {
+
+CountingHistogram::CountingHistogram(size_t width, size_t height)
+    : width_(width),
+      height_(height),
+      counts_(width * height, Counts{0, 0}),
+      spills_(height),
+      rowEpochs_(height, epoch_) {}
+
+void CountingHistogram::takeRow(CountingHistogram &other, size_t y) {
+  if (other.rowEpochs_[y] != other.epoch_) {
+    return;
+  }
+  settleRow(y);
+
+  size_t begin = y * width_;
+  for (size_t index = begin; index < begin + width_; index++) {
+    Counts &source = other.counts_[index];
+    addCounts(y, index, source.density, source.color);
+    source = Counts{0, 0};
+  }
+
+  auto &spills = spills_[y];
+  for (const auto &[index, wide] : other.spills_[y]) {
+    WideCounts &target = spills[index];
+    target.density += wide.density;
+    target.color += wide.color;
+  }
+  other.spills_[y].clear();
+}
+
+void CountingHistogram::clear() { epoch_++; }
+
+void CountingHistogram::resize(size_t width, size_t height) {
+  width_ = width;
+  height_ = height;
+  counts_.assign(width * height, Counts{0, 0});
+  spills_.assign(height, {});
+  rowEpochs_.assign(height, epoch_);
+}
+
+void CountingHistogram::toBins(size_t y, Bin *output) const {
+  if (rowEpochs_[y] != epoch_) {
+    std::fill(output, output + width_, Bin());
+    return;
+  }
+
+  size_t begin = y * width_;
+  for (size_t x = 0; x < width_; x++) {
+    const Counts &counts = counts_[begin + x];
+    output[x] = Bin(static_cast<float>(counts.density),
+                    static_cast<float>(counts.color) / COLOR_SCALE);
+  }
+  for (const auto &[index, wide] : spills_[y]) {
+    const Counts &counts = counts_[index];
+    output[index - begin] =
+        Bin(static_cast<float>(wide.density + counts.density),
+            static_cast<float>(wide.color + counts.color) / COLOR_SCALE);
+  }
+}
+
+void CountingHistogram::spill(size_t y, size_t index) {
+  Counts &counts = counts_[index];
+  WideCounts &wide = spills_[y][index];
+  wide.density += counts.density;
+  wide.color += counts.color;
+  counts = Counts{0, 0};
+}
+
+void CountingHistogram::zeroRow(size_t y) {
+  auto row = counts_.begin() + y * width_;
+  std::fill(row, row + width_, Counts{0, 0});
+  spills_[y].clear();
+  rowEpochs_[y] = epoch_;
+}
+
+}  // namespace chaoskit::core
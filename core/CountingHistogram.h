@@ -0,0 +1,100 @@
+#ifndef CHAOSKIT_CORE_COUNTINGHISTOGRAM_H
+#define CHAOSKIT_CORE_COUNTINGHISTOGRAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Bin.h"
+
+namespace chaoskit::core {
+
+/**
+ * A histogram of samples of weight 1 that counts them exactly, however many
+ * there are, where float bins stop growing once they reach 2^24.
+ *
+ * Each pixel holds a 32-bit count and a 32-bit sum of color coordinates in
+ * fixed point. A pixel about to overflow either of them moves both to 64-bit
+ * counters kept aside for its row, which only happens to the hottest pixels.
+ * Different rows can be written from different threads.
+ *
+ * Like HistogramBuffer, clear() only marks rows as stale, and a stale row is
+ * zeroed when it's written to for the first time.
+ */
+class CountingHistogram {
+ public:
+  /** Color coordinates are counted in steps of 1 / COLOR_SCALE. */
+  static constexpr uint32_t COLOR_SCALE = 1 << 12;
+
+  CountingHistogram() : CountingHistogram(0, 0) {}
+  CountingHistogram(size_t width, size_t height);
+
+  [[nodiscard]] size_t width() const { return width_; }
+  [[nodiscard]] size_t height() const { return height_; }
+  [[nodiscard]] size_t size() const { return counts_.size(); }
+
+  /** Counts a sample, its color is clamped to [0; 1]. */
+  void add(size_t x, size_t y, float color) {
+    settleRow(y);
+    addCounts(y, y * width_ + x, 1, quantize(color));
+  }
+
+  /**
+   * Adds row `y` of `other`, which has the same size, and zeroes it there.
+   */
+  void takeRow(CountingHistogram &other, size_t y);
+
+  void clear();
+  void resize(size_t width, size_t height);
+
+  /** Converts the counts of row `y` to `width()` bins. */
+  void toBins(size_t y, Bin *output) const;
+
+ private:
+  struct Counts {
+    uint32_t density;
+    uint32_t color;
+  };
+  struct WideCounts {
+    uint64_t density = 0;
+    uint64_t color = 0;
+  };
+
+  static uint32_t quantize(float color) {
+    // Written so that NaN counts as 0.
+    float clamped = color > 0.f ? std::min(color, 1.f) : 0.f;
+    return static_cast<uint32_t>(clamped * COLOR_SCALE + .5f);
+  }
+
+  void addCounts(size_t y, size_t index, uint64_t density, uint64_t color) {
+    Counts &counts = counts_[index];
+    if (counts.density + density > UINT32_MAX ||
+        counts.color + color > UINT32_MAX) {
+      spill(y, index);
+    }
+    // Adding to a spilled pixel can't overflow, as the arguments are at most
+    // what another pixel holds.
+    counts.density += static_cast<uint32_t>(density);
+    counts.color += static_cast<uint32_t>(color);
+  }
+  void spill(size_t y, size_t index);
+  void settleRow(size_t y) {
+    if (rowEpochs_[y] != epoch_) {
+      zeroRow(y);
+    }
+  }
+  void zeroRow(size_t y);
+
+  size_t width_, height_;
+  std::vector<Counts> counts_;
+  /** Counts that didn't fit in `counts_`, by pixel index, for each row. */
+  std::vector<std::unordered_map<size_t, WideCounts>> spills_;
+  /** Bumped by clear(), rows from older epochs are logically zero. */
+  uint32_t epoch_ = 0;
+  std::vector<uint32_t> rowEpochs_;
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_COUNTINGHISTOGRAM_H
@@ -0,0 +1,94 @@
+#include <gmock/gmock.h>
+
+#include <vector>
+#include "CountingHistogram.h"
+
+namespace chaoskit::core {
+
+using testing::FloatEq;
+
+class CountingHistogramTest : public testing::Test {
+ protected:
+  static Bin binAt(const CountingHistogram &histogram, size_t x, size_t y) {
+    std::vector<Bin> row(histogram.width());
+    histogram.toBins(y, row.data());
+    return row[x];
+  }
+};
+
+TEST_F(CountingHistogramTest, CountsSamplesAndColors) {
+  CountingHistogram histogram(2, 2);
+
+  histogram.add(1, 0, .5f);
+  histogram.add(1, 0, .25f);
+
+  ASSERT_THAT(binAt(histogram, 1, 0).density, FloatEq(2.f));
+  ASSERT_THAT(binAt(histogram, 1, 0).color, FloatEq(.75f));
+  ASSERT_THAT(binAt(histogram, 0, 0).density, FloatEq(0.f));
+}
+
+TEST_F(CountingHistogramTest, ClampsColors) {
+  CountingHistogram histogram(1, 1);
+
+  histogram.add(0, 0, 2.f);
+  histogram.add(0, 0, -1.f);
+
+  ASSERT_THAT(binAt(histogram, 0, 0).color, FloatEq(1.f));
+}
+
+TEST_F(CountingHistogramTest, KeepsCountingPastFloatPrecision) {
+  CountingHistogram histogram(1, 1);
+
+  for (uint32_t i = 0; i < (1u << 24) + 2; i++) {
+    histogram.add(0, 0, 0.f);
+  }
+
+  ASSERT_THAT(binAt(histogram, 0, 0).density,
+              FloatEq(static_cast<float>((1u << 24) + 2)));
+}
+
+TEST_F(CountingHistogramTest, SpillsColorSumsThatOverflow) {
+  CountingHistogram histogram(2, 1);
+  constexpr uint32_t scale = CountingHistogram::COLOR_SCALE;
+  // Enough to overflow 32 bits of color sums.
+  uint32_t samples = UINT32_MAX / scale + scale;
+
+  for (uint32_t i = 0; i < samples; i++) {
+    histogram.add(1, 0, 1.f);
+  }
+
+  ASSERT_THAT(binAt(histogram, 1, 0).density,
+              FloatEq(static_cast<float>(samples)));
+  ASSERT_THAT(binAt(histogram, 1, 0).color,
+              FloatEq(static_cast<float>(samples)));
+}
+
+TEST_F(CountingHistogramTest, TakesRowsOfOtherHistograms) {
+  CountingHistogram histogram(2, 2);
+  CountingHistogram shard(2, 2);
+  histogram.add(0, 1, 1.f);
+  shard.add(0, 1, 0.f);
+  shard.add(1, 0, 0.f);
+
+  histogram.takeRow(shard, 1);
+
+  ASSERT_THAT(binAt(histogram, 0, 1).density, FloatEq(2.f));
+  ASSERT_THAT(binAt(histogram, 1, 0).density, FloatEq(0.f));
+  ASSERT_THAT(binAt(shard, 0, 1).density, FloatEq(0.f));
+  ASSERT_THAT(binAt(shard, 1, 0).density, FloatEq(1.f));
+}
+
+TEST_F(CountingHistogramTest, ClearsLazily) {
+  CountingHistogram histogram(2, 2);
+  histogram.add(0, 0, 1.f);
+  histogram.add(1, 1, 1.f);
+
+  histogram.clear();
+  ASSERT_THAT(binAt(histogram, 0, 0).density, FloatEq(0.f));
+
+  histogram.add(1, 1, 1.f);
+  ASSERT_THAT(binAt(histogram, 1, 1).density, FloatEq(1.f));
+  ASSERT_THAT(binAt(histogram, 0, 0).density, FloatEq(0.f));
+}
+
+}  // namespace chaoskit::core
@@ -0,0 +1,34 @@
+#ifndef CHAOSKIT_CORE_FASTRNG_H
+#define CHAOSKIT_CORE_FASTRNG_H
+
+#include "Rng.h"
+#include "Xoshiro128.h"
+
+namespace chaoskit::core {
+
+/**
+ * An Rng with its own Xoshiro128 state. It is final, so calls made through a
+ * FastRng (rather than an Rng) are resolved statically.
+ */
+class FastRng final : public Rng {
+ public:
+  FastRng() = default;
+  explicit FastRng(uint64_t seed) : generator_(seed) {}
+
+  float randomFloat(float min, float max) override {
+    return generator_.randomFloat(min, max);
+  }
+  int randomInt(int min, int max) override {
+    return generator_.randomInt(min, max);
+  }
+  void fill(float *out, size_t count, float min, float max) override {
+    generator_.fill(out, count, min, max);
+  }
+
+ private:
+  Xoshiro128 generator_;
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_FASTRNG_H
@@ -1,16 +1,200 @@
 #include "HistogramBuffer.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace chaoskit::core {
 
+namespace {
+
+struct Tap {
+  size_t index;
+  float weight;
+};
+
+/**
+ * For each target pixel on one axis, the source pixels it covers and how
+ * much of each.
+ */
+std::vector<std::vector<Tap>> axisTaps(size_t targetSize, size_t sourceSize,
+                                       float ratio, float offset) {
+  std::vector<std::vector<Tap>> taps(targetSize);
+  auto sourceEnd = static_cast<float>(sourceSize);
+  for (size_t target = 0; target < targetSize; target++) {
+    float begin = static_cast<float>(target) * ratio + offset;
+    float low = std::max(begin, 0.f);
+    float high = std::min(begin + ratio, sourceEnd);
+    for (float pixel = std::floor(low); pixel < high; pixel++) {
+      float weight = std::min(high, pixel + 1.f) - std::max(low, pixel);
+      if (weight > 0.f) {
+        taps[target].push_back({static_cast<size_t>(pixel), weight});
+      }
+    }
+  }
+  return taps;
+}
+
+}  // namespace
+
 void HistogramBuffer::clear() {
-  std::fill(buffer_.begin(), buffer_.end(), Color::zero());
+  epoch_++;
+  std::fill(tileVersions_.begin(), tileVersions_.end(), version_);
 }
 
 void HistogramBuffer::resize(size_t width, size_t height) {
-  clear();
-  buffer_.resize(width * height);
+  buffer_.assign(storageSize(width, height, layout_), Bin());
   width_ = width;
   height_ = height;
+  tileColumns_ = tileCount(width);
+  tileVersions_.assign(tileColumns_ * tileCount(height), version_);
+  tileEpochs_.assign(tileVersions_.size(), epoch_);
+}
+
+void HistogramBuffer::scale(float factor) {
+  for (size_t tile = 0; tile < tileVersions_.size(); tile++) {
+    tileVersions_[tile] = version_;
+    if (isStale(tile)) {
+      continue;
+    }
+    Region region = tileRegion(tile);
+    for (size_t y = region.y; y < region.y + region.height; y++) {
+      Bin* row = &buffer_[index(region.x, y)];
+      for (size_t x = 0; x < region.width; x++) {
+        row[x] *= factor;
+      }
+    }
+  }
+}
+
+void HistogramBuffer::settle() {
+  for (size_t tile = 0; tile < tileEpochs_.size(); tile++) {
+    settleTile(tile);
+  }
+}
+
+HistogramBuffer::Region HistogramBuffer::tileRegion(size_t tile) const {
+  size_t x = (tile % tileColumns_) * TILE_SIZE;
+  size_t y = (tile / tileColumns_) * TILE_SIZE;
+  return {x, y, std::min(TILE_SIZE, width_ - x),
+          std::min(TILE_SIZE, height_ - y)};
+}
+
+void HistogramBuffer::zeroTile(size_t tile) {
+  Region region = tileRegion(tile);
+  for (size_t y = region.y; y < region.y + region.height; y++) {
+    auto row = buffer_.begin() + index(region.x, y);
+    std::fill(row, row + region.width, Bin());
+  }
+  tileEpochs_[tile] = epoch_;
+}
+
+void HistogramBuffer::resampleFrom(const HistogramBuffer& source,
+                                   const Resampling& resampling) {
+  auto columns = axisTaps(width_, source.width_, resampling.ratioX,
+                          resampling.offsetX);
+  auto rows = axisTaps(height_, source.height_, resampling.ratioY,
+                       resampling.offsetY);
+
+  for (size_t y = 0; y < height_; y++) {
+    for (size_t x = 0; x < width_; x++) {
+      Bin sum;
+      for (const auto& row : rows[y]) {
+        for (const auto& column : columns[x]) {
+          if (source.isStale(source.tileIndex(column.index, row.index))) {
+            continue;
+          }
+          Bin bin = *source.pixel(column.index, row.index);
+          bin *= row.weight * column.weight;
+          sum += bin;
+        }
+      }
+      sum *= resampling.gain;
+      buffer_[index(x, y)] = sum;
+    }
+  }
+
+  std::fill(tileVersions_.begin(), tileVersions_.end(), version_);
+  std::fill(tileEpochs_.begin(), tileEpochs_.end(), epoch_);
+}
+
+void HistogramBuffer::copyTo(Bin* output) const {
+  for (size_t tile = 0; tile < tileVersions_.size(); tile++) {
+    Region region = tileRegion(tile);
+    for (size_t y = region.y; y < region.y + region.height; y++) {
+      Bin* target = output + y * width_ + region.x;
+      if (isStale(tile)) {
+        std::fill(target, target + region.width, Bin());
+      } else {
+        const Bin* source = &buffer_[index(tile, region.x, y)];
+        std::copy(source, source + region.width, target);
+      }
+    }
+  }
+}
+
+void HistogramBuffer::addChanged(const HistogramBuffer& other,
+                                 uint64_t since) {
+  if (other.width_ != width_ || other.height_ != height_) {
+    return;
+  }
+
+  for (size_t tile = 0; tile < tileVersions_.size(); tile++) {
+    if (other.tileVersions_[tile] <= since || other.isStale(tile)) {
+      continue;
+    }
+    // A stale tile is zero, so it can take the other one as is.
+    bool copy = isStale(tile);
+    Region region = tileRegion(tile);
+    for (size_t y = region.y; y < region.y + region.height; y++) {
+      Bin* target = &buffer_[index(region.x, y)];
+      const Bin* source = &other.buffer_[index(region.x, y)];
+      if (copy) {
+        std::copy(source, source + region.width, target);
+      } else {
+        for (size_t x = 0; x < region.width; x++) {
+          target[x] += source[x];
+        }
+      }
+    }
+    tileEpochs_[tile] = epoch_;
+    tileVersions_[tile] = version_;
+  }
+}
+
+void HistogramBuffer::copyChanged(const HistogramBuffer& other,
+                                  uint64_t since) {
+  if (other.width_ != width_ || other.height_ != height_) {
+    *this = other;
+    return;
+  }
+
+  for (size_t tile = 0; tile < tileVersions_.size(); tile++) {
+    if (other.tileVersions_[tile] <= since) {
+      continue;
+    }
+    tileVersions_[tile] = other.tileVersions_[tile];
+    if (other.isStale(tile)) {
+      markStale(tile);
+      continue;
+    }
+    Region region = tileRegion(tile);
+    for (size_t y = region.y; y < region.y + region.height; y++) {
+      auto source = other.buffer_.begin() + index(region.x, y);
+      std::copy(source, source + region.width,
+                buffer_.begin() + index(region.x, y));
+    }
+    tileEpochs_[tile] = epoch_;
+  }
+  version_ = other.version_;
+}
+
+void HistogramBuffer::clearChanged(uint64_t since) {
+  for (size_t tile = 0; tile < tileVersions_.size(); tile++) {
+    if (tileVersions_[tile] > since) {
+      markStale(tile);
+      tileVersions_[tile] = version_;
+    }
+  }
 }
 
 }  // namespace chaoskit::core
@@ -2,35 +2,211 @@
 #define CHAOSKIT_CORE_HISTOGRAMBUFFER_H
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
-#include "Color.h"
+#include "Bin.h"
 
 namespace chaoskit::core {
 
+/**
+ * A grid of bins, split into square tiles that remember the version at
+ * which they last changed, so that consumers can process only what changed
+ * since they last looked.
+ *
+ * Changes made through add(), clear() and resize() are tracked, writing
+ * through operator() or data() is not.
+ *
+ * clear() only marks tiles as stale, and a stale tile is zeroed when it's
+ * written to for the first time, or by settle(). The non-const accessors
+ * settle what they return, but the const ones don't: readers of a shared
+ * buffer should skip stale tiles as zero, like copyTo() does.
+ *
+ * Pixels are stored row by row, or tile by tile with Layout::Tiled, where
+ * hits close to each other share cache lines and pages however large the
+ * buffer is. Either way, the rows of a tile are contiguous, rowPitch() bins
+ * apart, and copyTo() exports the buffer row by row.
+ */
 class HistogramBuffer {
  public:
+  static constexpr size_t TILE_SIZE = 64;
+
+  /**
+   * Where the pixels of a buffer fall in another one of a different size:
+   * pixel (x, y) covers the other buffer's pixels from (x * ratioX + offsetX,
+   * y * ratioY + offsetY), ratioX by ratioY of them.
+   */
+  struct Resampling {
+    float ratioX = 1.f, ratioY = 1.f;
+    float offsetX = 0.f, offsetY = 0.f;
+    /** Factor applied to every resampled value. */
+    float gain = 1.f;
+  };
+
+  /** A rectangle of pixels, at most TILE_SIZE in both dimensions. */
+  struct Region {
+    size_t x, y, width, height;
+  };
+
+  enum class Layout {
+    /** Row by row, data() is a plain image. */
+    Linear,
+    /** Tile by tile, each padded to TILE_SIZE by TILE_SIZE. */
+    Tiled,
+  };
+
   HistogramBuffer() : HistogramBuffer(0, 0) {}
-  HistogramBuffer(size_t width, size_t height)
-      : width_(width), height_(height), buffer_(width * height) {}
+  HistogramBuffer(size_t width, size_t height, Layout layout = Layout::Linear)
+      : layout_(layout),
+        width_(width),
+        height_(height),
+        buffer_(storageSize(width, height, layout)),
+        tileColumns_(tileCount(width)),
+        tileVersions_(tileColumns_ * tileCount(height), version_),
+        tileEpochs_(tileVersions_.size(), epoch_) {}
 
-  Color* operator()(size_t x, size_t y) { return &buffer_[index(x, y)]; }
+  Bin* operator()(size_t x, size_t y) {
+    size_t tile = tileIndex(x, y);
+    settleTile(tile);
+    return &buffer_[index(tile, x, y)];
+  }
+
+  void add(size_t x, size_t y, const Bin& bin) {
+    size_t tile = tileIndex(x, y);
+    settleTile(tile);
+    buffer_[index(tile, x, y)] += bin;
+    tileVersions_[tile] = version_;
+  }
 
+  [[nodiscard]] Layout layout() const { return layout_; }
   [[nodiscard]] size_t width() const { return width_; }
   [[nodiscard]] size_t height() const { return height_; }
-  [[nodiscard]] size_t size() const { return buffer_.size(); }
+  /** Number of pixels. */
+  [[nodiscard]] size_t size() const { return width_ * height_; }
   void clear();
+  /** Resizes the buffer, keeping its layout. */
   void resize(size_t width, size_t height);
+  /** Multiplies every pixel by `factor`. */
+  void scale(float factor);
+
+  /** The bins in storage order, see Layout. */
+  Bin* data() {
+    settle();
+    return buffer_.data();
+  }
+  [[nodiscard]] const Bin* data() const { return buffer_.data(); }
+
+  /**
+   * Where pixel (x, y) is stored. The next rowPitch() bins hold the rest of
+   * its row within its tile.
+   */
+  [[nodiscard]] const Bin* pixel(size_t x, size_t y) const {
+    return &buffer_[index(x, y)];
+  }
+  [[nodiscard]] size_t rowPitch() const {
+    return layout_ == Layout::Linear ? width_ : TILE_SIZE;
+  }
+
+  /**
+   * Whether `tile` was cleared and not written to since. Whatever it stores
+   * is left over from before, it should be read as zero.
+   */
+  [[nodiscard]] bool isStale(const Region& tile) const {
+    return isStale(tileIndex(tile.x, tile.y));
+  }
+
+  /** Copies the buffer to `output` row by row, whatever its layout. */
+  void copyTo(Bin* output) const;
 
-  Color* data() { return buffer_.data(); }
-  [[nodiscard]] const Color* data() const { return buffer_.data(); }
+  /** Zeroes the tiles left stale by clear(). */
+  void settle();
+
+  /** Version that tracked changes are stamped with. */
+  [[nodiscard]] uint64_t version() const { return version_; }
+  void setVersion(uint64_t version) { version_ = version; }
+
+  /** Calls `action` with every tile that changed after version `since`. */
+  template <typename Action>
+  void forEachChangedTile(uint64_t since, Action action) const {
+    for (size_t tile = 0; tile < tileVersions_.size(); tile++) {
+      if (tileVersions_[tile] > since) {
+        action(tileRegion(tile));
+      }
+    }
+  }
+
+  /**
+   * Adds the tiles of `other` that changed after version `since`. Does
+   * nothing if the sizes differ.
+   */
+  void addChanged(const HistogramBuffer& other, uint64_t since);
+
+  /**
+   * Makes this buffer equal to `other`, assuming both were equal at version
+   * `since` and only `other` changed after it. Copies everything if the
+   * sizes differ.
+   */
+  void copyChanged(const HistogramBuffer& other, uint64_t since);
+
+  /** Clears the tiles that changed after version `since`. */
+  void clearChanged(uint64_t since);
+
+  /**
+   * Overwrites every pixel with the sum of the pixels of `source` it covers,
+   * weighted by how much of them it covers, so that the total is kept apart
+   * from what falls outside.
+   */
+  void resampleFrom(const HistogramBuffer& source,
+                    const Resampling& resampling);
 
  private:
+  static constexpr size_t TILE_AREA = TILE_SIZE * TILE_SIZE;
+
+  static size_t tileCount(size_t pixels) {
+    return (pixels + TILE_SIZE - 1) / TILE_SIZE;
+  }
+  static size_t storageSize(size_t width, size_t height, Layout layout) {
+    return layout == Layout::Linear
+               ? width * height
+               : tileCount(width) * tileCount(height) * TILE_AREA;
+  }
+
   [[nodiscard]] size_t index(size_t x, size_t y) const {
-    return y * width_ + x;
+    if (layout_ == Layout::Linear) {
+      return y * width_ + x;
+    }
+    return index(tileIndex(x, y), x, y);
+  }
+  /** Same as index(x, y), for a pixel of `tile`. */
+  [[nodiscard]] size_t index(size_t tile, size_t x, size_t y) const {
+    if (layout_ == Layout::Linear) {
+      return y * width_ + x;
+    }
+    return tile * TILE_AREA + (y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE;
+  }
+  [[nodiscard]] size_t tileIndex(size_t x, size_t y) const {
+    return (y / TILE_SIZE) * tileColumns_ + x / TILE_SIZE;
+  }
+  [[nodiscard]] Region tileRegion(size_t tile) const;
+  [[nodiscard]] bool isStale(size_t tile) const {
+    return tileEpochs_[tile] != epoch_;
+  }
+  void markStale(size_t tile) { tileEpochs_[tile] = epoch_ - 1; }
+  void settleTile(size_t tile) {
+    if (isStale(tile)) {
+      zeroTile(tile);
+    }
   }
+  void zeroTile(size_t tile);
 
+  Layout layout_;
   size_t width_, height_;
-  std::vector<Color> buffer_;
+  std::vector<Bin> buffer_;
+  uint64_t version_ = 1;
+  size_t tileColumns_;
+  std::vector<uint64_t> tileVersions_;
+  /** Bumped by clear(), tiles from older epochs are logically zero. */
+  uint32_t epoch_ = 0;
+  std::vector<uint32_t> tileEpochs_;
 };
 
 }  // namespace chaoskit::core
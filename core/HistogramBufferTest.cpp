@@ -0,0 +1,283 @@
+#include <gmock/gmock.h>
+
+#include <vector>
+#include "HistogramBuffer.h"
+
+namespace chaoskit::core {
+
+using testing::ElementsAre;
+using testing::Eq;
+using testing::FloatEq;
+using testing::IsEmpty;
+
+class HistogramBufferTest : public testing::Test {
+ protected:
+  static constexpr size_t TILE = HistogramBuffer::TILE_SIZE;
+
+  static std::vector<size_t> changedTileOrigins(const HistogramBuffer &buffer,
+                                                uint64_t since) {
+    std::vector<size_t> origins;
+    buffer.forEachChangedTile(since, [&](const HistogramBuffer::Region &tile) {
+      origins.push_back(tile.x);
+      origins.push_back(tile.y);
+    });
+    return origins;
+  }
+};
+
+TEST_F(HistogramBufferTest, StartsZeroed) {
+  HistogramBuffer buffer(3, 2);
+
+  for (size_t i = 0; i < buffer.size(); i++) {
+    ASSERT_THAT(buffer.data()[i].density, FloatEq(0.f));
+  }
+}
+
+TEST_F(HistogramBufferTest, TracksTilesChangedByAdd) {
+  HistogramBuffer buffer(2 * TILE, 2 * TILE);
+  buffer.setVersion(2);
+
+  buffer.add(TILE + 1, 3, Bin{1.f, 0.f});
+
+  ASSERT_THAT(changedTileOrigins(buffer, 1), ElementsAre(TILE, 0u));
+  ASSERT_THAT(changedTileOrigins(buffer, 2), IsEmpty());
+}
+
+TEST_F(HistogramBufferTest, ClipsTilesAtEdges) {
+  HistogramBuffer buffer(TILE + 5, 3);
+  buffer.setVersion(2);
+  buffer.add(TILE + 4, 2, Bin{1.f, 0.f});
+
+  std::vector<HistogramBuffer::Region> tiles;
+  buffer.forEachChangedTile(
+      1, [&](const HistogramBuffer::Region &tile) { tiles.push_back(tile); });
+
+  ASSERT_THAT(tiles.size(), Eq(1u));
+  ASSERT_THAT(tiles[0].width, Eq(5u));
+  ASSERT_THAT(tiles[0].height, Eq(3u));
+}
+
+TEST_F(HistogramBufferTest, ClearChangesEveryTile) {
+  HistogramBuffer buffer(2 * TILE, TILE);
+  buffer.setVersion(2);
+
+  buffer.clear();
+
+  ASSERT_THAT(changedTileOrigins(buffer, 1), ElementsAre(0u, 0u, TILE, 0u));
+}
+
+TEST_F(HistogramBufferTest, ScalesEveryPixel) {
+  HistogramBuffer buffer(2 * TILE, TILE);
+  buffer.add(TILE, 0, Bin{4.f, 2.f});
+  buffer.setVersion(2);
+
+  buffer.scale(0.25f);
+
+  ASSERT_THAT(buffer(TILE, 0)->color, FloatEq(0.5f));
+  ASSERT_THAT(buffer(TILE, 0)->density, FloatEq(1.f));
+  ASSERT_THAT(changedTileOrigins(buffer, 1), ElementsAre(0u, 0u, TILE, 0u));
+}
+
+TEST_F(HistogramBufferTest, ZeroesClearedTileOnFirstWrite) {
+  HistogramBuffer buffer(2, 2);
+  buffer.add(0, 0, Bin{3.f, 0.f});
+  buffer.add(1, 1, Bin{3.f, 0.f});
+
+  buffer.clear();
+  buffer.add(1, 1, Bin{1.f, 0.f});
+
+  const auto &view = buffer;
+  ASSERT_THAT(view.data()[0].density, FloatEq(0.f));
+  ASSERT_THAT(view.data()[3].density, FloatEq(1.f));
+}
+
+TEST_F(HistogramBufferTest, SettlesClearedTiles) {
+  HistogramBuffer buffer(2 * TILE, TILE);
+  buffer.add(0, 0, Bin{3.f, 0.f});
+  buffer.add(TILE, 0, Bin{3.f, 0.f});
+
+  buffer.clear();
+  buffer.settle();
+
+  const auto &view = buffer;
+  ASSERT_THAT(view.data()[0].density, FloatEq(0.f));
+  ASSERT_THAT(view.data()[TILE].density, FloatEq(0.f));
+}
+
+TEST_F(HistogramBufferTest, AddsIntoClearedTiles) {
+  HistogramBuffer delta(2, 2);
+  delta.setVersion(2);
+  delta.add(1, 0, Bin{1.f, 0.f});
+  HistogramBuffer total(2, 2);
+  total.add(0, 0, Bin{3.f, 0.f});
+  total.clear();
+
+  total.addChanged(delta, 1);
+
+  ASSERT_THAT(total(0, 0)->density, FloatEq(0.f));
+  ASSERT_THAT(total(1, 0)->density, FloatEq(1.f));
+}
+
+TEST_F(HistogramBufferTest, CopiesClearedTiles) {
+  HistogramBuffer source(2, 2);
+  HistogramBuffer target(2, 2);
+  target.add(0, 0, Bin{3.f, 0.f});
+  source.setVersion(2);
+  source.clear();
+
+  target.copyChanged(source, 1);
+
+  ASSERT_THAT(target(0, 0)->density, FloatEq(0.f));
+}
+
+TEST_F(HistogramBufferTest, AddsOnlyChangedTiles) {
+  HistogramBuffer delta(2 * TILE, TILE);
+  delta.setVersion(2);
+  delta.add(0, 0, Bin{1.f, 0.f});
+  // Not tracked, so it must not be merged.
+  delta(TILE, 0)->density = 5.f;
+  HistogramBuffer total(2 * TILE, TILE);
+  total.setVersion(7);
+
+  total.addChanged(delta, 1);
+
+  ASSERT_THAT(total(0, 0)->density, FloatEq(1.f));
+  ASSERT_THAT(total(TILE, 0)->density, FloatEq(0.f));
+  ASSERT_THAT(changedTileOrigins(total, 6), ElementsAre(0u, 0u));
+}
+
+TEST_F(HistogramBufferTest, CopiesOnlyChangedTiles) {
+  HistogramBuffer source(2 * TILE, TILE);
+  HistogramBuffer target(2 * TILE, TILE);
+  source.setVersion(2);
+  source.add(TILE, 0, Bin{1.f, 0.f});
+
+  target.copyChanged(source, 1);
+
+  ASSERT_THAT(target(TILE, 0)->density, FloatEq(1.f));
+  ASSERT_THAT(target.version(), Eq(2u));
+  ASSERT_THAT(changedTileOrigins(target, 1), ElementsAre(TILE, 0u));
+}
+
+TEST_F(HistogramBufferTest, CopiesEverythingWhenSizesDiffer) {
+  HistogramBuffer source(3, 3);
+  HistogramBuffer target(1, 1);
+  source.add(2, 2, Bin{1.f, 0.f});
+
+  target.copyChanged(source, 1);
+
+  ASSERT_THAT(target.width(), Eq(3u));
+  ASSERT_THAT(target(2, 2)->density, FloatEq(1.f));
+}
+
+TEST_F(HistogramBufferTest, ClearsOnlyChangedTiles) {
+  HistogramBuffer buffer(2 * TILE, TILE);
+  *buffer(TILE, 0) = Bin{5.f, 0.f};
+  buffer.setVersion(2);
+  buffer.add(0, 0, Bin{1.f, 0.f});
+
+  buffer.clearChanged(1);
+
+  ASSERT_THAT(buffer(0, 0)->density, FloatEq(0.f));
+  ASSERT_THAT(buffer(TILE, 0)->density, FloatEq(5.f));
+}
+
+TEST_F(HistogramBufferTest, ResamplesKeepingTheTotal) {
+  HistogramBuffer source(4, 4);
+  source.add(1, 2, Bin{8.f, 0.f});
+  HistogramBuffer smaller(2, 2);
+  HistogramBuffer larger(8, 8);
+
+  HistogramBuffer::Resampling down;
+  down.ratioX = down.ratioY = 2.f;
+  smaller.resampleFrom(source, down);
+  HistogramBuffer::Resampling up;
+  up.ratioX = up.ratioY = 0.5f;
+  larger.resampleFrom(source, up);
+
+  ASSERT_THAT(smaller(0, 1)->density, FloatEq(8.f));
+  ASSERT_THAT(smaller(1, 1)->density, FloatEq(0.f));
+  ASSERT_THAT(larger(2, 4)->density, FloatEq(2.f));
+  ASSERT_THAT(larger(3, 5)->density, FloatEq(2.f));
+  ASSERT_THAT(larger(4, 4)->density, FloatEq(0.f));
+}
+
+TEST_F(HistogramBufferTest, ResamplesWithOffsetAndGain) {
+  HistogramBuffer source(4, 1);
+  source.add(2, 0, Bin{4.f, 0.f});
+  HistogramBuffer target(4, 1);
+  target.add(3, 0, Bin{1.f, 0.f});
+  target.setVersion(2);
+
+  HistogramBuffer::Resampling resampling;
+  resampling.offsetX = 1.5f;
+  resampling.gain = 0.5f;
+  target.resampleFrom(source, resampling);
+
+  ASSERT_THAT(target(0, 0)->density, FloatEq(1.f));
+  ASSERT_THAT(target(1, 0)->density, FloatEq(1.f));
+  ASSERT_THAT(target(3, 0)->density, FloatEq(0.f));
+  ASSERT_THAT(changedTileOrigins(target, 1), ElementsAre(0u, 0u));
+}
+
+TEST_F(HistogramBufferTest, ResamplesClearedTilesAsZero) {
+  HistogramBuffer source(2, 1);
+  source.add(1, 0, Bin{4.f, 0.f});
+  source.clear();
+  HistogramBuffer target(1, 1);
+
+  HistogramBuffer::Resampling down;
+  down.ratioX = 2.f;
+  target.resampleFrom(source, down);
+
+  ASSERT_THAT(target(0, 0)->density, FloatEq(0.f));
+}
+
+TEST_F(HistogramBufferTest, StoresTiledLayoutTileByTile) {
+  HistogramBuffer buffer(TILE + 2, 2, HistogramBuffer::Layout::Tiled);
+
+  buffer.add(TILE + 1, 1, Bin{3.f, 0.f});
+
+  ASSERT_THAT(buffer.rowPitch(), Eq(TILE));
+  ASSERT_THAT(buffer.pixel(TILE + 1, 1) - buffer.data(),
+              Eq(static_cast<std::ptrdiff_t>(TILE * TILE + TILE + 1)));
+  ASSERT_THAT(buffer(TILE + 1, 1)->density, FloatEq(3.f));
+}
+
+TEST_F(HistogramBufferTest, CopiesTiledLayoutRowByRow) {
+  HistogramBuffer buffer(TILE + 2, 2, HistogramBuffer::Layout::Tiled);
+  buffer.add(1, 0, Bin{1.f, 0.f});
+  buffer.add(TILE + 1, 1, Bin{2.f, 0.f});
+  std::vector<Bin> output(buffer.size(), Bin{5.f, 5.f});
+
+  buffer.copyTo(output.data());
+
+  ASSERT_THAT(output[1].density, FloatEq(1.f));
+  ASSERT_THAT(output[(TILE + 2) + TILE + 1].density, FloatEq(2.f));
+  ASSERT_THAT(output[TILE].density, FloatEq(0.f));
+}
+
+TEST_F(HistogramBufferTest, CopiesClearedTilesAsZero) {
+  HistogramBuffer buffer(2, 2, HistogramBuffer::Layout::Tiled);
+  buffer.add(1, 1, Bin{1.f, 0.f});
+  buffer.clear();
+  std::vector<Bin> output(buffer.size(), Bin{5.f, 5.f});
+
+  buffer.copyTo(output.data());
+
+  ASSERT_THAT(output[3].density, FloatEq(0.f));
+}
+
+TEST_F(HistogramBufferTest, ResamplesTiledLayout) {
+  HistogramBuffer source(4, 4, HistogramBuffer::Layout::Tiled);
+  source.add(1, 2, Bin{8.f, 0.f});
+  HistogramBuffer target(2, 2, HistogramBuffer::Layout::Tiled);
+
+  HistogramBuffer::Resampling down;
+  down.ratioX = down.ratioY = 2.f;
+  target.resampleFrom(source, down);
+
+  ASSERT_THAT(target(0, 1)->density, FloatEq(8.f));
+}
+
+}  // namespace chaoskit::core
@@ -0,0 +1,378 @@
+#include "Jit.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+#define CHAOSKIT_JIT_X86_64
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace chaoskit::core {
+
+#if defined(CHAOSKIT_JIT_X86_64)
+
+namespace {
+
+float frac(float value) {
+  float unused;
+  return modff(value, &unused);
+}
+
+/**
+ * Emits x86-64 code for the System V ABI. Every register of the program
+ * lives in memory at [rbx + 4 * register], and each instruction is compiled
+ * to a few SSE operations on xmm0-xmm3.
+ */
+class Assembler {
+ public:
+  explicit Assembler(bool hasSse41) : hasSse41_(hasSse41) {}
+
+  [[nodiscard]] const std::vector<uint8_t> &bytes() const { return bytes_; }
+
+  size_t function(const Program &program, const BlendCode &blend) {
+    size_t offset = bytes_.size();
+    emit({0x53});              // push rbx
+    emit({0x48, 0x89, 0xfb});  // mov rbx, rdi
+    for (uint32_t i = blend.begin; i < blend.end; i++) {
+      instruction(program.code[i]);
+    }
+    emit({0x5b, 0xc3});  // pop rbx; ret
+    return offset;
+  }
+
+ private:
+  // ModRM bytes for [rbx + disp32] with the given register in the reg field.
+  static constexpr uint8_t EAX = 0x83;
+  static constexpr uint8_t XMM0 = 0x83;
+  static constexpr uint8_t XMM1 = 0x8b;
+  static constexpr uint8_t XMM3 = 0x9b;
+
+  // Immediate operands of cmpss.
+  static constexpr uint8_t CMP_EQ = 0;
+  static constexpr uint8_t CMP_LT = 1;
+  static constexpr uint8_t CMP_LE = 2;
+  static constexpr uint8_t CMP_NEQ = 4;
+
+  // Immediate operands of roundss.
+  static constexpr uint8_t ROUND_FLOOR = 0x09;
+  static constexpr uint8_t ROUND_CEIL = 0x0a;
+  static constexpr uint8_t ROUND_TRUNC = 0x0b;
+
+  // Opcodes of <op> eax, imm32.
+  static constexpr uint8_t AND_EAX = 0x25;
+  static constexpr uint8_t OR_EAX = 0x0d;
+  static constexpr uint8_t XOR_EAX = 0x35;
+
+  static constexpr uint32_t SIGN_BIT = 0x80000000;
+  static constexpr uint32_t ONE = 0x3f800000;
+
+  std::vector<uint8_t> bytes_;
+  bool hasSse41_;
+
+  void emit(std::initializer_list<uint8_t> bytes) {
+    bytes_.insert(bytes_.end(), bytes);
+  }
+  void emit32(uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+      bytes_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+  }
+  void emit64(uint64_t value) {
+    emit32(static_cast<uint32_t>(value));
+    emit32(static_cast<uint32_t>(value >> 32));
+  }
+  void address(Register r) { emit32(static_cast<uint32_t>(r) * 4); }
+
+  void load(uint8_t xmm, Register r) {
+    emit({0xf3, 0x0f, 0x10, xmm});  // movss xmm, [rbx + r]
+    address(r);
+  }
+  void store(Register r) {
+    emit({0xf3, 0x0f, 0x11, XMM0});  // movss [rbx + r], xmm0
+    address(r);
+  }
+  void arithmetic(uint8_t opcode, const Instruction &i) {
+    load(XMM0, i.a);
+    emit({0xf3, 0x0f, opcode, XMM0});  // <op>ss xmm0, [rbx + b]
+    address(i.b);
+    store(i.out);
+  }
+  void bitwise(std::initializer_list<std::pair<uint8_t, uint32_t>> operations,
+               const Instruction &i) {
+    emit({0x8b, EAX});  // mov eax, [rbx + a]
+    address(i.a);
+    for (const auto &[opcode, mask] : operations) {
+      emit({opcode});  // <op> eax, mask
+      emit32(mask);
+    }
+    emit({0x89, EAX});  // mov [rbx + out], eax
+    address(i.out);
+  }
+  void call(float (*function)(float), const Instruction &i) {
+    load(XMM0, i.a);
+    callAndStore(reinterpret_cast<uintptr_t>(function), i.out);
+  }
+  void call(float (*function)(float, float), const Instruction &i) {
+    load(XMM0, i.a);
+    load(XMM1, i.b);
+    callAndStore(reinterpret_cast<uintptr_t>(function), i.out);
+  }
+  void callAndStore(uintptr_t function, Register out) {
+    emit({0x48, 0xb8});  // mov rax, function
+    emit64(function);
+    emit({0xff, 0xd0});  // call rax
+    store(out);
+  }
+  void round(uint8_t mode, float (*fallback)(float), const Instruction &i) {
+    if (!hasSse41_) {
+      call(fallback, i);
+      return;
+    }
+    load(XMM0, i.a);
+    emit({0x66, 0x0f, 0x3a, 0x0a, 0xc0, mode});  // roundss xmm0, xmm0, mode
+    store(i.out);
+  }
+  void truth() {
+    emit({0xb8});  // mov eax, 1.f
+    emit32(ONE);
+    emit({0x66, 0x0f, 0x6e, 0xd0});  // movd xmm2, eax
+    emit({0x0f, 0x54, 0xc2});        // andps xmm0, xmm2
+  }
+  void compare(uint8_t predicate, Register a, Register b, Register out) {
+    load(XMM0, a);
+    emit({0xf3, 0x0f, 0xc2, XMM0});  // cmpss xmm0, [rbx + b], predicate
+    address(b);
+    emit({predicate});
+    truth();
+    store(out);
+  }
+  void logical(uint8_t opcode, const Instruction &i) {
+    emit({0x0f, 0x57, 0xc9});  // xorps xmm1, xmm1
+    load(XMM0, i.a);
+    emit({0xf3, 0x0f, 0xc2, 0xc1, CMP_NEQ});  // cmpss xmm0, xmm1, neq
+    load(XMM3, i.b);
+    emit({0xf3, 0x0f, 0xc2, 0xd9, CMP_NEQ});  // cmpss xmm3, xmm1, neq
+    emit({0x0f, opcode, 0xc3});               // andps/orps xmm0, xmm3
+    truth();
+    store(i.out);
+  }
+
+  void instruction(const Instruction &i) {
+    switch (i.op) {
+      case OpCode::SIN:
+        call(&::sinf, i);
+        break;
+      case OpCode::COS:
+        call(&::cosf, i);
+        break;
+      case OpCode::TAN:
+        call(&::tanf, i);
+        break;
+      case OpCode::MINUS:
+        bitwise({{XOR_EAX, SIGN_BIT}}, i);
+        break;
+      case OpCode::SQRT:
+        emit({0xf3, 0x0f, 0x51, XMM0});  // sqrtss xmm0, [rbx + a]
+        address(i.a);
+        store(i.out);
+        break;
+      case OpCode::ATAN:
+        call(&::atanf, i);
+        break;
+      case OpCode::TRUNC:
+        round(ROUND_TRUNC, &::truncf, i);
+        break;
+      case OpCode::EXP:
+        call(&::expf, i);
+        break;
+      case OpCode::FLOOR:
+        round(ROUND_FLOOR, &::floorf, i);
+        break;
+      case OpCode::CEIL:
+        round(ROUND_CEIL, &::ceilf, i);
+        break;
+      case OpCode::SIGNUM:
+        bitwise({{AND_EAX, SIGN_BIT}, {OR_EAX, ONE}}, i);
+        break;
+      case OpCode::ABS:
+        bitwise({{AND_EAX, ~SIGN_BIT}}, i);
+        break;
+      case OpCode::NOT:
+        emit({0x0f, 0x57, 0xc9});  // xorps xmm1, xmm1
+        load(XMM0, i.a);
+        emit({0xf3, 0x0f, 0xc2, 0xc1, CMP_EQ});  // cmpss xmm0, xmm1, eq
+        truth();
+        store(i.out);
+        break;
+      case OpCode::FRAC:
+        call(&frac, i);
+        break;
+      case OpCode::ADD:
+        arithmetic(0x58, i);
+        break;
+      case OpCode::SUBTRACT:
+        arithmetic(0x5c, i);
+        break;
+      case OpCode::MULTIPLY:
+        arithmetic(0x59, i);
+        break;
+      case OpCode::DIVIDE:
+        arithmetic(0x5e, i);
+        break;
+      case OpCode::POWER:
+        call(&::powf, i);
+        break;
+      case OpCode::MODULO:
+        call(&::fmodf, i);
+        break;
+      case OpCode::AND:
+        logical(0x54, i);
+        break;
+      case OpCode::OR:
+        logical(0x56, i);
+        break;
+      case OpCode::LESS_THAN:
+        compare(CMP_LT, i.a, i.b, i.out);
+        break;
+      case OpCode::GREATER_THAN:
+        compare(CMP_LT, i.b, i.a, i.out);
+        break;
+      case OpCode::EQUALS:
+        compare(CMP_EQ, i.a, i.b, i.out);
+        break;
+      case OpCode::LESS_THAN_OR_EQUAL:
+        compare(CMP_LE, i.a, i.b, i.out);
+        break;
+      case OpCode::GREATER_THAN_OR_EQUAL:
+        compare(CMP_LE, i.b, i.a, i.out);
+        break;
+      case OpCode::DISTANCE:
+        arithmetic(0x5c, i);
+        emit({0x81, 0xa3});  // and dword [rbx + out], ~SIGN_BIT
+        address(i.out);
+        emit32(~SIGN_BIT);
+        break;
+    }
+  }
+};
+
+std::string structureKey(const Program &program) {
+  std::string key;
+  auto append = [&key](uint32_t value) {
+    key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  };
+  auto appendBlend = [&](const BlendCode &blend) {
+    append(blend.begin);
+    append(blend.end);
+  };
+
+  for (const auto &i : program.code) {
+    append(i.op._to_integral());
+    append(i.out);
+    append(i.a);
+    append(i.b);
+  }
+  append(static_cast<uint32_t>(program.blends.size()));
+  for (const auto &blend : program.blends) {
+    appendBlend(blend);
+  }
+  appendBlend(program.finalBlend);
+  return key;
+}
+
+std::shared_ptr<const NativeProgram> assemble(const Program &program) {
+  static const bool hasSse41 = __builtin_cpu_supports("sse4.1");
+  Assembler assembler(hasSse41);
+
+  std::vector<size_t> offsets;
+  for (const auto &blend : program.blends) {
+    offsets.push_back(assembler.function(program, blend));
+  }
+  size_t finalOffset = assembler.function(program, program.finalBlend);
+
+  // Code is written while the pages are writable, then switched to
+  // executable, so that no page is ever both.
+  const auto &bytes = assembler.bytes();
+  auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t size = (bytes.size() + pageSize - 1) / pageSize * pageSize;
+  void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    return nullptr;
+  }
+  std::memcpy(memory, bytes.data(), bytes.size());
+  if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+    munmap(memory, size);
+    return nullptr;
+  }
+
+  auto *base = static_cast<uint8_t *>(memory);
+  auto at = [base](size_t offset) {
+    return reinterpret_cast<NativeProgram::BlendFunction>(base + offset);
+  };
+  std::vector<NativeProgram::BlendFunction> blends;
+  for (size_t offset : offsets) {
+    blends.push_back(at(offset));
+  }
+  return std::make_shared<NativeProgram>(memory, size, std::move(blends),
+                                         at(finalOffset));
+}
+
+}  // namespace
+
+NativeProgram::~NativeProgram() { munmap(memory_, size_); }
+
+bool isJitSupported() { return true; }
+
+std::shared_ptr<const NativeProgram> jitCompile(const Program &program) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::weak_ptr<const NativeProgram>>
+      cache;
+
+  std::string key = structureKey(program);
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (auto it = cache.find(key); it != cache.end()) {
+    if (auto code = it->second.lock()) {
+      return code;
+    }
+  }
+
+  auto code = assemble(program);
+  for (auto it = cache.begin(); it != cache.end();) {
+    it = it->second.expired() ? cache.erase(it) : std::next(it);
+  }
+  if (code) {
+    cache[key] = code;
+  }
+  return code;
+}
+
+#else
+
+NativeProgram::~NativeProgram() = default;
+
+bool isJitSupported() { return false; }
+
+std::shared_ptr<const NativeProgram> jitCompile(const Program &) {
+  return nullptr;
+}
+
+#endif
+
+NativeProgram::NativeProgram(void *memory, size_t size,
+                             std::vector<BlendFunction> blends,
+                             BlendFunction finalBlend)
+    : memory_(memory),
+      size_(size),
+      blends_(std::move(blends)),
+      finalBlend_(finalBlend) {}
+
+}  // namespace chaoskit::core
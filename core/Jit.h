@@ -0,0 +1,50 @@
+#ifndef CHAOSKIT_CORE_JIT_H
+#define CHAOSKIT_CORE_JIT_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Bytecode.h"
+
+namespace chaoskit::core {
+
+/** Machine code for every blend of a Program, produced by jitCompile(). */
+class NativeProgram {
+ public:
+  /** Runs one blend over the register file of an interpreter. */
+  using BlendFunction = void (*)(float *registers);
+
+  NativeProgram(void *memory, size_t size, std::vector<BlendFunction> blends,
+                BlendFunction finalBlend);
+  NativeProgram(const NativeProgram &) = delete;
+  NativeProgram &operator=(const NativeProgram &) = delete;
+  ~NativeProgram();
+
+  [[nodiscard]] BlendFunction blend(size_t index) const {
+    return blends_[index];
+  }
+  [[nodiscard]] BlendFunction finalBlend() const { return finalBlend_; }
+
+ private:
+  void *memory_;
+  size_t size_;
+  std::vector<BlendFunction> blends_;
+  BlendFunction finalBlend_;
+};
+
+/** Whether jitCompile() can produce code on this platform. */
+bool isJitSupported();
+
+/**
+ * Translates a program to native code, without any external compiler.
+ *
+ * Code only depends on the instructions and register numbers, not on
+ * constant or parameter values, so programs with the same structure share
+ * code through a cache. Returns nullptr when the platform or the program is
+ * not supported, in which case the bytecode has to be interpreted.
+ */
+std::shared_ptr<const NativeProgram> jitCompile(const Program &program);
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_JIT_H
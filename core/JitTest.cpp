@@ -0,0 +1,113 @@
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "BytecodeCompiler.h"
+#include "BytecodeInterpreter.h"
+#include "Jit.h"
+#include "ast/helpers.h"
+#include "library/DeJong.h"
+#include "library/Drain.h"
+#include "library/coloring_methods/Distance.h"
+
+namespace chaoskit::core {
+
+using ast::helpers::make_system;
+using testing::Eq;
+
+class JitTest : public testing::Test {};
+
+namespace {
+
+uint32_t bits(float value) {
+  uint32_t result;
+  std::memcpy(&result, &value, sizeof(result));
+  return result;
+}
+
+}  // namespace
+
+TEST_F(JitTest, MatchesInterpreterForEveryFunction) {
+  if (!isJitSupported()) {
+    return;
+  }
+
+  ast::helpers::InputHelper input;
+  std::vector<ast::Expression> expressions;
+  for (auto type : ast::UnaryFunction_Type::_values()) {
+    expressions.emplace_back(ast::UnaryFunction(type, input.x()));
+  }
+  for (auto type : ast::BinaryFunction_Type::_values()) {
+    expressions.emplace_back(ast::BinaryFunction(type, input.x(), input.y()));
+  }
+
+  float infinity = std::numeric_limits<float>::infinity();
+  float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> values{0.f,    -0.f,   1.f,      -1.f,      .5f, -2.5f,
+                            3.7f,   -1e30f, 1e-40f,   infinity,  -infinity,
+                            nan};
+
+  for (size_t e = 0; e < expressions.size(); e++) {
+    auto system = make_system(ast::Formula{expressions[e], 0.f});
+    BytecodeInterpreter interpreter(system);
+    BytecodeInterpreter jit(system);
+    jit.setBackend(ExecutionBackend::Jit);
+    ASSERT_THAT(+jit.backend(), Eq(+ExecutionBackend::Jit));
+
+    for (float a : values) {
+      for (float b : values) {
+        Particle particle{{a, b}, .5f, Particle::IMMORTAL};
+        float expected = interpreter(particle).output.x();
+        float actual = jit(particle).output.x();
+        ASSERT_THAT(bits(actual), Eq(bits(expected)))
+            << "expression " << e << " at (" << a << ", " << b << ")";
+      }
+    }
+  }
+}
+
+TEST_F(JitTest, MatchesInterpreterOnSystem) {
+  ast::Transform pre(.9f, -.1f, .05f, .1f, .9f, -.05f);
+  ast::Blend blend(
+      {ast::WeightedFormula(library::DeJong().source(), .7f, .6f),
+       ast::WeightedFormula(library::Drain().source(), .3f, .4f)},
+      pre, ast::Transform::identity(),
+      library::coloring_methods::Distance().source());
+  ast::Blend final_blend({}, ast::Transform::identity(), pre);
+  ast::System system{{ast::LimitedBlend(blend, 1.f)}, final_blend};
+
+  Params params;
+  params[SystemIndex{0, 0}] = {1.4f, -2.3f, 2.4f, -2.1f};
+  params[SystemIndex{0, 1}] = {.7f, -.5f, .3f, 0.f};
+  params[SystemIndex{0, SystemIndex::COLORING_METHOD}] = {.2f};
+
+  BytecodeInterpreter interpreter(system, Particle::IMMORTAL, params);
+  BytecodeInterpreter jit(system, Particle::IMMORTAL, params);
+  jit.setBackend(ExecutionBackend::Jit);
+
+  auto particle = interpreter.randomizeParticle();
+  for (int i = 0; i < 10000; i++) {
+    auto expected = interpreter(particle);
+    auto actual = jit(particle);
+    ASSERT_THAT(actual.output, Eq(expected.output)) << "at iteration " << i;
+    particle = expected.next_state;
+  }
+}
+
+TEST_F(JitTest, SharesCodeBetweenSystemsWithSameStructure) {
+  if (!isJitSupported()) {
+    return;
+  }
+
+  using namespace ast::helpers;
+  ParameterHelper params;
+  auto system = make_system(ast::Formula{params[0] * 2.f, params[1]});
+
+  auto first = jitCompile(compile(system));
+  auto second = jitCompile(compile(system));
+
+  ASSERT_THAT(first, Eq(second));
+}
+
+}  // namespace chaoskit::core
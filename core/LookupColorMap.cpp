@@ -0,0 +1,21 @@
+#include "LookupColorMap.h"
+
+namespace chaoskit::core {
+
+LookupColorMap::LookupColorMap(const ColorMap &source, size_t size)
+    : entries_(std::max<size_t>(size, 2)),
+      scale_(static_cast<float>(entries_.size() - 1)) {
+  for (size_t i = 0; i < entries_.size(); i++) {
+    entries_[i] = source.map(static_cast<float>(i) / scale_);
+  }
+}
+
+void LookupColorMap::mapMany(const float *colors, size_t count,
+                             Color *output) const {
+  const Color *entries = entries_.data();
+  for (size_t i = 0; i < count; i++) {
+    output[i] = entries[index(colors[i])];
+  }
+}
+
+}  // namespace chaoskit::core
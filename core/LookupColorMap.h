@@ -0,0 +1,41 @@
+#ifndef CHAOSKIT_CORE_LOOKUPCOLORMAP_H
+#define CHAOSKIT_CORE_LOOKUPCOLORMAP_H
+
+#include <algorithm>
+#include <vector>
+#include "ColorMap.h"
+
+namespace chaoskit::core {
+
+/**
+ * Another color map sampled into a table of evenly spaced entries, so that
+ * mapping costs a lookup however the original computes its colors. Colors
+ * outside of [0; 1] are clamped, NaN maps like 0.
+ */
+class LookupColorMap : public ColorMap {
+ public:
+  static constexpr size_t DEFAULT_SIZE = 4096;
+
+  explicit LookupColorMap(const ColorMap &source, size_t size = DEFAULT_SIZE);
+
+  [[nodiscard]] Color map(float color) const override {
+    return entries_[index(color)];
+  }
+  void mapMany(const float *colors, size_t count,
+               Color *output) const override;
+
+  [[nodiscard]] size_t size() const { return entries_.size(); }
+
+ private:
+  std::vector<Color> entries_;
+  float scale_;
+
+  [[nodiscard]] size_t index(float color) const {
+    float clamped = color > 0.f ? std::min(color, 1.f) : 0.f;
+    return static_cast<size_t>(clamped * scale_ + .5f);
+  }
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_LOOKUPCOLORMAP_H
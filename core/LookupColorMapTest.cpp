@@ -0,0 +1,65 @@
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <vector>
+#include "BlackWhiteColorMap.h"
+#include "ColorMapRegistry.h"
+#include "LookupColorMap.h"
+#include "RainbowColorMap.h"
+
+namespace chaoskit::core {
+
+using testing::FloatEq;
+using testing::FloatNear;
+
+class LookupColorMapTest : public testing::Test {};
+
+TEST_F(LookupColorMapTest, MatchesSourceAtEntries) {
+  RainbowColorMap source;
+  LookupColorMap lookup(source, 5);
+
+  for (float color : {0.f, .25f, .5f, .75f, 1.f}) {
+    ASSERT_THAT(lookup.map(color).r, FloatEq(source.map(color).r));
+    ASSERT_THAT(lookup.map(color).g, FloatEq(source.map(color).g));
+    ASSERT_THAT(lookup.map(color).b, FloatEq(source.map(color).b));
+  }
+}
+
+TEST_F(LookupColorMapTest, PicksNearestEntry) {
+  LookupColorMap lookup(BlackWhiteColorMap(), 5);
+
+  ASSERT_THAT(lookup.map(.3f).r, FloatEq(.25f));
+  ASSERT_THAT(lookup.map(.4f).r, FloatEq(.5f));
+}
+
+TEST_F(LookupColorMapTest, ClampsColors) {
+  LookupColorMap lookup(BlackWhiteColorMap(), 5);
+
+  ASSERT_THAT(lookup.map(-1.f).r, FloatEq(0.f));
+  ASSERT_THAT(lookup.map(2.f).r, FloatEq(1.f));
+  ASSERT_THAT(lookup.map(std::nanf("")).r, FloatEq(0.f));
+}
+
+TEST_F(LookupColorMapTest, MapsManyLikeOne) {
+  LookupColorMap lookup(RainbowColorMap(), 64);
+  std::vector<float> colors{0.f, .1f, .33f, .9f, 1.f};
+  std::vector<Color> output(colors.size());
+
+  lookup.mapMany(colors.data(), colors.size(), output.data());
+
+  for (size_t i = 0; i < colors.size(); i++) {
+    ASSERT_THAT(output[i].g, FloatEq(lookup.map(colors[i]).g));
+  }
+}
+
+TEST_F(LookupColorMapTest, RegistryBakesColorMaps) {
+  ColorMapRegistry registry(4096);
+  RainbowColorMap source;
+
+  const ColorMap *colorMap = registry.get("Rainbow");
+
+  ASSERT_NE(dynamic_cast<const LookupColorMap *>(colorMap), nullptr);
+  ASSERT_THAT(colorMap->map(.3f).r, FloatNear(source.map(.3f).r, 1e-3f));
+}
+
+}  // namespace chaoskit::core
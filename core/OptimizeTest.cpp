@@ -0,0 +1,109 @@
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include "BytecodeCompiler.h"
+#include "ast/helpers.h"
+#include "optimize.h"
+
+namespace chaoskit::core {
+
+using namespace ast::helpers;
+using testing::Eq;
+using testing::SizeIs;
+
+class OptimizeTest : public testing::Test {};
+
+TEST_F(OptimizeTest, FoldsConstants) {
+  ast::Expression expression = plus(n(2.f) * n(3.f), sin(n(0.f)));
+
+  ASSERT_THAT(optimize(expression), Eq(ast::Expression(6.f)));
+}
+
+TEST_F(OptimizeTest, SimplifiesIdentities) {
+  InputHelper input;
+
+  ASSERT_THAT(optimize(input.x() * n(1.f)), Eq(ast::Expression(input.x())));
+  ASSERT_THAT(optimize(n(1.f) * input.x()), Eq(ast::Expression(input.x())));
+  ASSERT_THAT(optimize(plus(input.x(), n(0.f))),
+              Eq(ast::Expression(input.x())));
+  ASSERT_THAT(optimize(subtract(input.x(), n(0.f))),
+              Eq(ast::Expression(input.x())));
+  ASSERT_THAT(optimize(input.x() / n(1.f)), Eq(ast::Expression(input.x())));
+  ASSERT_THAT(optimize(negative(negative(input.x()))),
+              Eq(ast::Expression(input.x())));
+}
+
+TEST_F(OptimizeTest, SimplifiesAfterFolding) {
+  InputHelper input;
+
+  ASSERT_THAT(optimize(input.y() * subtract(n(3.f), n(2.f))),
+              Eq(ast::Expression(input.y())));
+}
+
+TEST_F(OptimizeTest, BakesParameters) {
+  ParameterHelper params;
+  auto system = make_system(ast::Formula{params[0], params[1] * n(2.f)});
+  Params values;
+  values[SystemIndex{0, 0}] = {3.f, 4.f};
+
+  auto optimized = optimize(system, values);
+
+  ASSERT_THAT(optimized, Eq(make_system(ast::Formula{3.f, 8.f})));
+}
+
+TEST_F(OptimizeTest, KeepsMissingParameters) {
+  ParameterHelper params;
+  auto system = make_system(ast::Formula{params[0], params[1]});
+  Params values;
+  values[SystemIndex{0, 0}] = {3.f};
+
+  auto optimized = optimize(system, values);
+
+  ASSERT_THAT(optimized, Eq(make_system(ast::Formula{3.f, params[1]})));
+}
+
+TEST_F(OptimizeTest, DropsZeroWeightFormulas) {
+  ast::Formula formula{1.f, 2.f};
+  ast::System system{{ast::LimitedBlend(
+      ast::Blend({ast::WeightedFormula(formula, 0.f),
+                  ast::WeightedFormula(formula, .5f),
+                  ast::WeightedFormula(formula, 0.f)}),
+      1.f)}};
+
+  auto optimized = optimize(system);
+
+  ASSERT_THAT(optimized.blends()[0].blend().formulas(),
+              Eq(std::vector<ast::WeightedFormula>{
+                  ast::WeightedFormula(formula, .5f)}));
+}
+
+TEST_F(OptimizeTest, KeepsFormulaPositionsForParameters) {
+  ParameterHelper params;
+  ast::System system{{ast::LimitedBlend(
+      ast::Blend({ast::WeightedFormula(ast::Formula{1.f, 2.f}, 0.f),
+                  ast::WeightedFormula(ast::Formula{params[0], 2.f})}),
+      1.f)}};
+
+  auto optimized = optimize(system);
+
+  ASSERT_THAT(optimized.blends()[0].blend().formulas(), SizeIs(2));
+}
+
+TEST_F(OptimizeTest, CompilerEliminatesCommonSubexpressions) {
+  InputHelper input;
+  OutputHelper output;
+  ast::Expression dx = subtract(input.x(), output.x());
+  auto system = make_system(ast::Formula{dx * dx, dx});
+
+  auto program = compile(system);
+
+  auto count = [&](OpCode op) {
+    return std::count_if(
+        program.code.begin(), program.code.end(),
+        [op](const Instruction &instruction) { return instruction.op == op; });
+  };
+  ASSERT_THAT(count(OpCode::SUBTRACT), Eq(1));
+  ASSERT_THAT(count(OpCode::MULTIPLY), Eq(1));
+}
+
+}  // namespace chaoskit::core
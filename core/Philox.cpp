@@ -0,0 +1,54 @@
+#include "Philox.h"
+
+namespace chaoskit::core {
+
+namespace {
+
+constexpr uint32_t MULTIPLIER_0 = 0xD2511F53;
+constexpr uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+constexpr uint32_t WEYL_0 = 0x9E3779B9;
+constexpr uint32_t WEYL_1 = 0xBB67AE85;
+constexpr int ROUNDS = 10;
+
+}  // namespace
+
+std::array<uint32_t, 4> philox(std::array<uint32_t, 4> counter,
+                               std::array<uint32_t, 2> key) {
+  for (int round = 0; round < ROUNDS; round++) {
+    if (round > 0) {
+      key[0] += WEYL_0;
+      key[1] += WEYL_1;
+    }
+    uint64_t product0 = static_cast<uint64_t>(MULTIPLIER_0) * counter[0];
+    uint64_t product1 = static_cast<uint64_t>(MULTIPLIER_1) * counter[2];
+    counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+               static_cast<uint32_t>(product1),
+               static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+               static_cast<uint32_t>(product0)};
+  }
+  return counter;
+}
+
+PhiloxRng::PhiloxRng(uint64_t seed, uint64_t stream, uint64_t position)
+    : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+      stream_(stream) {
+  seek(position);
+}
+
+void PhiloxRng::seek(uint64_t position) {
+  block_number_ = position / block_.size();
+  refill();
+  index_ = position % block_.size();
+}
+
+void PhiloxRng::refill() {
+  block_ = philox({static_cast<uint32_t>(block_number_),
+                   static_cast<uint32_t>(block_number_ >> 32),
+                   static_cast<uint32_t>(stream_),
+                   static_cast<uint32_t>(stream_ >> 32)},
+                  key_);
+  ++block_number_;
+  index_ = 0;
+}
+
+}  // namespace chaoskit::core
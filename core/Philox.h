@@ -0,0 +1,77 @@
+#ifndef CHAOSKIT_CORE_PHILOX_H
+#define CHAOSKIT_CORE_PHILOX_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include "Rng.h"
+#include "uniform.h"
+
+namespace chaoskit::core {
+
+/**
+ * The Philox4x32-10 bijection (Salmon et al., "Parallel random numbers: as
+ * easy as 1, 2, 3"). Maps a 128-bit counter to 128 random bits under a 64-bit
+ * key.
+ */
+std::array<uint32_t, 4> philox(std::array<uint32_t, 4> counter,
+                               std::array<uint32_t, 2> key);
+
+/**
+ * A counter-based Rng: the n-th number of a stream is a pure function of
+ * (seed, stream, n), so any stream can be started at any position without
+ * generating what comes before.
+ *
+ * Renders stay reproducible when they are split between threads or machines,
+ * as long as each unit of work uses its own stream, whatever the number of
+ * workers is. Different streams of the same seed don't overlap.
+ */
+class PhiloxRng final : public Rng {
+ public:
+  using result_type = uint32_t;
+
+  explicit PhiloxRng(uint64_t seed, uint64_t stream = 0,
+                     uint64_t position = 0);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    if (index_ == block_.size()) {
+      refill();
+    }
+    return block_[index_++];
+  }
+
+  /** Moves to the given position, counted in 32-bit words from the start. */
+  void seek(uint64_t position);
+  [[nodiscard]] uint64_t position() const {
+    return (block_number_ - 1) * block_.size() + index_;
+  }
+
+  float randomFloat(float min, float max) override {
+    return min + (max - min) * unitFloat((*this)());
+  }
+  int randomInt(int min, int max) override {
+    return uniformInt(*this, min, max);
+  }
+  void fill(float *out, size_t count, float min, float max) override {
+    fillUniform(*this, out, count, min, max);
+  }
+
+ private:
+  std::array<uint32_t, 2> key_;
+  uint64_t stream_;
+  /** Number of the block after the one in block_. */
+  uint64_t block_number_ = 0;
+  std::array<uint32_t, 4> block_{};
+  size_t index_ = 0;
+
+  void refill();
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_PHILOX_H
@@ -0,0 +1,92 @@
+#include <gmock/gmock.h>
+
+#include "BatchInterpreter.h"
+#include "Philox.h"
+#include "ast/helpers.h"
+
+namespace chaoskit::core {
+
+using testing::ElementsAre;
+using testing::ElementsAreArray;
+using testing::Ne;
+
+class PhiloxTest : public testing::Test {};
+
+std::vector<uint32_t> draw(PhiloxRng &rng, size_t count) {
+  std::vector<uint32_t> result;
+  for (size_t i = 0; i < count; i++) {
+    result.push_back(rng());
+  }
+  return result;
+}
+
+// Known answers from the Random123 distribution.
+TEST_F(PhiloxTest, MatchesReferenceVectors) {
+  EXPECT_THAT(philox({0, 0, 0, 0}, {0, 0}),
+              ElementsAre(0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u));
+  EXPECT_THAT(philox({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                     {0xffffffff, 0xffffffff}),
+              ElementsAre(0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu));
+  EXPECT_THAT(philox({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                     {0xa4093822, 0x299f31d0}),
+              ElementsAre(0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u));
+}
+
+TEST_F(PhiloxTest, StartsAtAnyPosition) {
+  PhiloxRng sequential(1234, 5);
+  auto expected = draw(sequential, 23);
+
+  for (uint64_t position : {0u, 1u, 4u, 7u, 13u}) {
+    PhiloxRng rng(1234, 5, position);
+    EXPECT_EQ(rng.position(), position);
+    EXPECT_THAT(draw(rng, 10),
+                ElementsAreArray(expected.begin() + position,
+                                 expected.begin() + position + 10));
+  }
+}
+
+TEST_F(PhiloxTest, SeeksBackwards) {
+  PhiloxRng rng(1, 2);
+  auto first = draw(rng, 9);
+
+  rng.seek(0);
+
+  ASSERT_THAT(draw(rng, 9), ElementsAreArray(first));
+}
+
+TEST_F(PhiloxTest, StreamsAndSeedsDiffer) {
+  PhiloxRng base(1, 0);
+  PhiloxRng otherStream(1, 1);
+  PhiloxRng otherSeed(2, 0);
+
+  auto values = draw(base, 8);
+
+  EXPECT_THAT(draw(otherStream, 8), Ne(values));
+  EXPECT_THAT(draw(otherSeed, 8), Ne(values));
+}
+
+TEST_F(PhiloxTest, MakesBatchesReproducible) {
+  ast::helpers::InputHelper input;
+  ast::System system{
+      {ast::LimitedBlend(
+           ast::Blend{{ast::WeightedFormula(ast::Formula{input.y(), .5f})}},
+           .4f),
+       ast::LimitedBlend(
+           ast::Blend{{ast::WeightedFormula(ast::Formula{.5f, input.x()})}},
+           1.f)}};
+  BatchInterpreter first(system, 100, 5, Params{},
+                         std::make_shared<PhiloxRng>(99));
+  BatchInterpreter second(system, 100, 5, Params{},
+                          std::make_shared<PhiloxRng>(99));
+
+  for (int i = 0; i < 20; i++) {
+    first.step();
+    second.step();
+  }
+
+  ASSERT_THAT(first.state().x, ElementsAreArray(second.state().x));
+  ASSERT_THAT(first.state().y, ElementsAreArray(second.state().y));
+  ASSERT_THAT(first.state().ttl, ElementsAreArray(second.state().ttl));
+}
+
+}  // namespace chaoskit::core
@@ -1,13 +1,27 @@
 #ifndef CHAOSKIT_CORE_RNG_H
 #define CHAOSKIT_CORE_RNG_H
 
+#include <cstddef>
+
 namespace chaoskit {
 namespace core {
 
 class Rng {
  public:
+  virtual ~Rng() = default;
+
   virtual float randomFloat(float min, float max) = 0;
   virtual int randomInt(int min, int max) = 0;
+
+  /**
+   * Fills `out` with `count` numbers in [min; max). Implementations should
+   * override it when they can do better than one call per number.
+   */
+  virtual void fill(float *out, size_t count, float min, float max) {
+    for (size_t i = 0; i < count; i++) {
+      out[i] = randomFloat(min, max);
+    }
+  }
 };
 
 }  // namespace core
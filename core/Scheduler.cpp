@@ -0,0 +1,204 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+
+namespace chaoskit::core {
+
+namespace {
+
+thread_local const void *current_scheduler = nullptr;
+thread_local size_t current_worker = 0;
+
+bool pop(std::mutex &mutex, std::deque<Scheduler::Task> &tasks,
+         Scheduler::Task &task, bool newest) {
+  std::lock_guard lock(mutex);
+  if (tasks.empty()) {
+    return false;
+  }
+  if (newest) {
+    task = std::move(tasks.back());
+    tasks.pop_back();
+  } else {
+    task = std::move(tasks.front());
+    tasks.pop_front();
+  }
+  return true;
+}
+
+}  // namespace
+
+Scheduler::Scheduler(size_t threadCount) {
+  threadCount = std::max<size_t>(threadCount, 1);
+  for (size_t i = 0; i < threadCount; i++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0; i < threadCount; i++) {
+    threads_.emplace_back(&Scheduler::work, this, i);
+  }
+}
+
+Scheduler::~Scheduler() {
+  {
+    std::lock_guard lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+Scheduler &Scheduler::shared() {
+  static Scheduler scheduler;
+  return scheduler;
+}
+
+size_t Scheduler::defaultThreadCount() {
+  return std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+}
+
+Scheduler::Worker *Scheduler::currentWorker() const {
+  return current_scheduler == this ? workers_[current_worker].get() : nullptr;
+}
+
+void Scheduler::submit(Task task, TaskPriority priority) {
+  auto level = static_cast<size_t>(priority._to_integral());
+  Worker *self = currentWorker();
+  Queue &queue = self ? self->queues[level] : injected_[level];
+
+  // Counted first, so that the counter never goes below the number of queued
+  // tasks.
+  {
+    std::lock_guard lock(sleep_mutex_);
+    ++pending_;
+  }
+  {
+    std::lock_guard lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  wake_.notify_one();
+}
+
+bool Scheduler::findTask(Worker *self, size_t worker, Task &task) {
+  bool found = false;
+  for (size_t level = 0; level < PRIORITY_COUNT && !found; level++) {
+    if (self) {
+      found = pop(self->queues[level].mutex, self->queues[level].tasks, task,
+                  true);
+    }
+    if (!found) {
+      found = pop(injected_[level].mutex, injected_[level].tasks, task, false);
+    }
+    for (size_t i = 1; i <= workers_.size() && !found; i++) {
+      Worker &victim = *workers_[(worker + i) % workers_.size()];
+      if (&victim != self) {
+        found = pop(victim.queues[level].mutex, victim.queues[level].tasks,
+                    task, false);
+      }
+    }
+  }
+  if (found) {
+    --pending_;
+  }
+  return found;
+}
+
+bool Scheduler::runPendingTask() {
+  if (pending_ == 0) {
+    return false;
+  }
+  Task task;
+  if (!findTask(currentWorker(), currentWorker() ? current_worker : 0, task)) {
+    return false;
+  }
+  task();
+  return true;
+}
+
+void Scheduler::work(size_t index) {
+  current_scheduler = this;
+  current_worker = index;
+
+  Worker *self = workers_[index].get();
+  Task task;
+  while (true) {
+    if (findTask(self, index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+
+    std::unique_lock lock(sleep_mutex_);
+    wake_.wait(lock, [this] { return stopping_ || pending_ > 0; });
+    if (stopping_ && pending_ == 0) {
+      return;
+    }
+  }
+}
+
+void Scheduler::parallelFor(size_t begin, size_t end, size_t grain,
+                            const std::function<void(size_t)> &body,
+                            TaskPriority priority) {
+  grain = std::max<size_t>(grain, 1);
+  TaskGroup group(*this, priority);
+  for (size_t start = begin; start < end; start += grain) {
+    size_t stop = std::min(end, start + grain);
+    group.run([&body, start, stop] {
+      for (size_t i = start; i < stop; i++) {
+        body(i);
+      }
+    });
+  }
+  group.wait();
+}
+
+// Tasks refer to the group, so it can't go away before they are done.
+TaskGroup::~TaskGroup() { join(); }
+
+void TaskGroup::run(Scheduler::Task task) {
+  ++remaining_;
+  scheduler_.submit(
+      [this, task = std::move(task)] {
+        try {
+          task();
+        } catch (...) {
+          std::lock_guard lock(mutex_);
+          if (!error_) {
+            error_ = std::current_exception();
+          }
+        }
+
+        std::lock_guard lock(mutex_);
+        if (--remaining_ == 0) {
+          done_.notify_all();
+        }
+      },
+      priority_);
+}
+
+void TaskGroup::join() {
+  while (remaining_ > 0) {
+    if (!scheduler_.runPendingTask()) {
+      break;
+    }
+  }
+
+  // Also waits for the last task to release the mutex.
+  std::unique_lock lock(mutex_);
+  done_.wait(lock, [this] { return remaining_ == 0; });
+}
+
+void TaskGroup::wait() {
+  join();
+
+  std::exception_ptr error;
+  {
+    std::lock_guard lock(mutex_);
+    std::swap(error, error_);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace chaoskit::core
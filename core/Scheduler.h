@@ -0,0 +1,118 @@
+#ifndef CHAOSKIT_CORE_SCHEDULER_H
+#define CHAOSKIT_CORE_SCHEDULER_H
+
+#include <enum.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chaoskit::core {
+
+/** Interactive tasks are always picked before any batch task. */
+BETTER_ENUM(TaskPriority, int, Interactive, Batch)
+
+/**
+ * A pool of threads with one deque of tasks per thread and priority.
+ *
+ * A worker runs its own newest task first and, when it runs out, takes the
+ * oldest task of another worker. Tasks submitted from other threads are
+ * shared by all workers. Priorities are only checked between tasks, so long
+ * jobs should be split into chunks to let interactive work through.
+ */
+class Scheduler {
+ public:
+  using Task = std::function<void()>;
+
+  explicit Scheduler(size_t threadCount = defaultThreadCount());
+  Scheduler(const Scheduler &) = delete;
+  Scheduler &operator=(const Scheduler &) = delete;
+  /** Finishes every submitted task, then stops the threads. */
+  ~Scheduler();
+
+  /** A scheduler with one thread per hardware thread, for the whole app. */
+  static Scheduler &shared();
+  static size_t defaultThreadCount();
+
+  [[nodiscard]] size_t threadCount() const { return threads_.size(); }
+
+  /** Queues a task. Tasks must not throw, use a TaskGroup for that. */
+  void submit(Task task, TaskPriority priority = TaskPriority::Batch);
+
+  /**
+   * Runs one queued task on the calling thread, if there is any. Returns
+   * whether it did.
+   */
+  bool runPendingTask();
+
+  /**
+   * Runs `body(i)` for every i in [begin; end), in tasks of `grain` indices,
+   * and returns when all of them are done. The calling thread takes part.
+   */
+  void parallelFor(size_t begin, size_t end, size_t grain,
+                   const std::function<void(size_t)> &body,
+                   TaskPriority priority = TaskPriority::Batch);
+
+ private:
+  /** One queue per TaskPriority. */
+  static constexpr size_t PRIORITY_COUNT = 2;
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+  struct Worker {
+    Queue queues[PRIORITY_COUNT];
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  Queue injected_[PRIORITY_COUNT];
+  std::vector<std::thread> threads_;
+
+  std::atomic<size_t> pending_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+
+  [[nodiscard]] Worker *currentWorker() const;
+  bool findTask(Worker *self, size_t worker, Task &task);
+  void work(size_t index);
+};
+
+/**
+ * Tasks that can be waited for together. The first exception thrown by any
+ * of them is rethrown by wait().
+ */
+class TaskGroup {
+ public:
+  explicit TaskGroup(Scheduler &scheduler,
+                     TaskPriority priority = TaskPriority::Batch)
+      : scheduler_(scheduler), priority_(priority) {}
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+  ~TaskGroup();
+
+  void run(Scheduler::Task task);
+
+  /** Returns when every task is done, running queued tasks meanwhile. */
+  void wait();
+
+ private:
+  Scheduler &scheduler_;
+  TaskPriority priority_;
+  std::atomic<size_t> remaining_{0};
+  std::mutex mutex_;
+  std::condition_variable done_;
+  std::exception_ptr error_;
+
+  void join();
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_SCHEDULER_H
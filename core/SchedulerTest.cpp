@@ -0,0 +1,105 @@
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include "Scheduler.h"
+
+namespace chaoskit::core {
+
+using testing::ElementsAre;
+using testing::Eq;
+
+class SchedulerTest : public testing::Test {};
+
+TEST_F(SchedulerTest, RunsSubmittedTasks) {
+  std::atomic<int> count{0};
+  {
+    Scheduler scheduler(4);
+    for (int i = 0; i < 1000; i++) {
+      scheduler.submit([&count] { ++count; });
+    }
+  }
+
+  ASSERT_THAT(count.load(), Eq(1000));
+}
+
+TEST_F(SchedulerTest, ParallelForVisitsEveryIndexOnce) {
+  Scheduler scheduler(4);
+  std::vector<std::atomic<int>> visits(1000);
+
+  scheduler.parallelFor(0, visits.size(), 7, [&visits](size_t i) {
+    ++visits[i];
+  });
+
+  for (const auto &count : visits) {
+    ASSERT_THAT(count.load(), Eq(1));
+  }
+}
+
+TEST_F(SchedulerTest, WaitsForNestedGroups) {
+  Scheduler scheduler(2);
+  std::atomic<int> count{0};
+
+  // Every outer task waits on inner tasks, more than there are threads.
+  TaskGroup outer(scheduler);
+  for (int i = 0; i < 8; i++) {
+    outer.run([&scheduler, &count] {
+      TaskGroup inner(scheduler);
+      for (int j = 0; j < 8; j++) {
+        inner.run([&count] { ++count; });
+      }
+      inner.wait();
+    });
+  }
+  outer.wait();
+
+  ASSERT_THAT(count.load(), Eq(64));
+}
+
+TEST_F(SchedulerTest, RethrowsFromGroup) {
+  Scheduler scheduler(2);
+  TaskGroup group(scheduler);
+  group.run([] { throw std::runtime_error("failed"); });
+  group.run([] {});
+
+  ASSERT_THROW(group.wait(), std::runtime_error);
+}
+
+TEST_F(SchedulerTest, RunsInteractiveTasksFirst) {
+  // With a single busy thread, queued tasks are picked in priority order.
+  Scheduler scheduler(1);
+  std::mutex mutex;
+  std::vector<int> order;
+  std::atomic<bool> release{false};
+
+  scheduler.submit([&release] {
+    while (!release) {
+      std::this_thread::yield();
+    }
+  });
+  for (int i = 0; i < 3; i++) {
+    scheduler.submit([&, i] {
+      std::lock_guard lock(mutex);
+      order.push_back(i);
+    });
+  }
+  scheduler.submit(
+      [&] {
+        std::lock_guard lock(mutex);
+        order.push_back(-1);
+      },
+      TaskPriority::Interactive);
+  release = true;
+
+  while (true) {
+    std::lock_guard lock(mutex);
+    if (order.size() == 4) {
+      break;
+    }
+  }
+
+  ASSERT_THAT(order, ElementsAre(-1, 0, 1, 2));
+}
+
+}  // namespace chaoskit::core
@@ -0,0 +1,75 @@
+#include "Simd.h"
+
+#include <cmath>
+#include "SimdExecutor.h"
+
+namespace chaoskit::core {
+
+namespace {
+
+/** Fallback used where no vector instruction set is available. */
+struct Scalar {
+  using Vector = float;
+  static constexpr size_t WIDTH = 1;
+
+  static Vector load(const float *p) { return *p; }
+  static void store(float *p, Vector v) { *p = v; }
+
+  static Vector minus(Vector a) { return -a; }
+  static Vector sqrt(Vector a) { return sqrtf(a); }
+  static Vector trunc(Vector a) { return truncf(a); }
+  static Vector floor(Vector a) { return floorf(a); }
+  static Vector ceil(Vector a) { return ceilf(a); }
+  static Vector signum(Vector a) { return std::signbit(a) ? -1.f : 1.f; }
+  static Vector abs(Vector a) { return fabsf(a); }
+  static Vector logicalNot(Vector a) { return !a; }
+  static Vector frac(Vector a) {
+    float unused;
+    return modff(a, &unused);
+  }
+
+  static Vector add(Vector a, Vector b) { return a + b; }
+  static Vector subtract(Vector a, Vector b) { return a - b; }
+  static Vector multiply(Vector a, Vector b) { return a * b; }
+  static Vector divide(Vector a, Vector b) { return a / b; }
+  static Vector logicalAnd(Vector a, Vector b) { return a && b; }
+  static Vector logicalOr(Vector a, Vector b) { return a || b; }
+  static Vector lessThan(Vector a, Vector b) { return a < b; }
+  static Vector equals(Vector a, Vector b) { return a == b; }
+  static Vector lessThanOrEqual(Vector a, Vector b) { return a <= b; }
+};
+
+}  // namespace
+
+SimdLevel detectSimdLevel() {
+#if defined(CHAOSKIT_X86_SIMD)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::Avx2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return SimdLevel::Sse41;
+  }
+#endif
+  return SimdLevel::Scalar;
+}
+
+BatchExecutor batchExecutor(SimdLevel level) {
+  static const SimdLevel supported = detectSimdLevel();
+  if (level > supported) {
+    level = supported;
+  }
+
+  switch (level) {
+#if defined(CHAOSKIT_X86_SIMD)
+    case SimdLevel::Avx2:
+      return avx2BatchExecutor();
+    case SimdLevel::Sse41:
+      return sse41BatchExecutor();
+#endif
+    default:
+      return &executeBatch<Scalar>;
+  }
+}
+
+}  // namespace chaoskit::core
@@ -0,0 +1,34 @@
+#ifndef CHAOSKIT_CORE_SIMD_H
+#define CHAOSKIT_CORE_SIMD_H
+
+#include <enum.h>
+#include <cstddef>
+#include "Bytecode.h"
+
+namespace chaoskit::core {
+
+BETTER_ENUM(SimdLevel, int, Scalar, Sse41, Avx2)
+
+/**
+ * Runs straight-line bytecode for `count` lanes at once. Register `r` of lane
+ * `i` lives at `registers[r * stride + i]`. Both `count` and `stride` have to
+ * be multiples of MAX_SIMD_WIDTH.
+ */
+using BatchExecutor = void (*)(const Instruction *begin,
+                               const Instruction *end, float *registers,
+                               size_t stride, size_t count);
+
+constexpr size_t MAX_SIMD_WIDTH = 8;
+
+/** Returns the best instruction set supported by the running CPU. */
+SimdLevel detectSimdLevel();
+
+/**
+ * Returns an executor for the given level. Levels that weren't compiled in or
+ * aren't supported by the CPU fall back to the best supported one.
+ */
+BatchExecutor batchExecutor(SimdLevel level);
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_SIMD_H
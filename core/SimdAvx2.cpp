@@ -0,0 +1,74 @@
+#include <immintrin.h>
+#include "SimdExecutor.h"
+
+namespace chaoskit::core {
+
+namespace {
+
+struct Avx2 {
+  using Vector = __m256;
+  static constexpr size_t WIDTH = 8;
+
+  static Vector load(const float *p) { return _mm256_loadu_ps(p); }
+  static void store(float *p, Vector v) { _mm256_storeu_ps(p, v); }
+
+  static Vector signMask() { return _mm256_set1_ps(-0.f); }
+  static Vector one() { return _mm256_set1_ps(1.f); }
+  static Vector truth(Vector mask) { return _mm256_and_ps(mask, one()); }
+
+  static Vector minus(Vector a) { return _mm256_xor_ps(a, signMask()); }
+  static Vector sqrt(Vector a) { return _mm256_sqrt_ps(a); }
+  static Vector trunc(Vector a) {
+    return _mm256_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  }
+  static Vector floor(Vector a) {
+    return _mm256_round_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+  }
+  static Vector ceil(Vector a) {
+    return _mm256_round_ps(a, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC);
+  }
+  static Vector signum(Vector a) {
+    return _mm256_or_ps(one(), _mm256_and_ps(a, signMask()));
+  }
+  static Vector abs(Vector a) { return _mm256_andnot_ps(signMask(), a); }
+  static Vector logicalNot(Vector a) {
+    return truth(_mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_EQ_OQ));
+  }
+  static Vector frac(Vector a) {
+    // Same as modff(): infinities give zero and the sign always follows a.
+    Vector finite =
+        _mm256_cmp_ps(abs(a), _mm256_set1_ps(INFINITY), _CMP_NEQ_UQ);
+    Vector difference = _mm256_and_ps(_mm256_sub_ps(a, trunc(a)), finite);
+    return _mm256_or_ps(abs(difference), _mm256_and_ps(a, signMask()));
+  }
+
+  static Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+  static Vector subtract(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+  static Vector multiply(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+  static Vector divide(Vector a, Vector b) { return _mm256_div_ps(a, b); }
+  static Vector logicalAnd(Vector a, Vector b) {
+    Vector zero = _mm256_setzero_ps();
+    return truth(_mm256_and_ps(_mm256_cmp_ps(a, zero, _CMP_NEQ_UQ),
+                               _mm256_cmp_ps(b, zero, _CMP_NEQ_UQ)));
+  }
+  static Vector logicalOr(Vector a, Vector b) {
+    Vector zero = _mm256_setzero_ps();
+    return truth(_mm256_or_ps(_mm256_cmp_ps(a, zero, _CMP_NEQ_UQ),
+                              _mm256_cmp_ps(b, zero, _CMP_NEQ_UQ)));
+  }
+  static Vector lessThan(Vector a, Vector b) {
+    return truth(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+  }
+  static Vector equals(Vector a, Vector b) {
+    return truth(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+  }
+  static Vector lessThanOrEqual(Vector a, Vector b) {
+    return truth(_mm256_cmp_ps(a, b, _CMP_LE_OQ));
+  }
+};
+
+}  // namespace
+
+BatchExecutor avx2BatchExecutor() { return &executeBatch<Avx2>; }
+
+}  // namespace chaoskit::core
@@ -0,0 +1,155 @@
+#ifndef CHAOSKIT_CORE_SIMDEXECUTOR_H
+#define CHAOSKIT_CORE_SIMDEXECUTOR_H
+
+// This header is only meant to be included by the Simd*.cpp files, each of
+// which is compiled for a different instruction set and instantiates
+// executeBatch() with its own Isa type.
+
+#include <cmath>
+#include <cstddef>
+#include "Bytecode.h"
+#include "Simd.h"
+
+namespace chaoskit::core {
+
+template <typename Isa, typename Function>
+void mapLanes(float *out, const float *a, size_t count, Function function) {
+  for (size_t i = 0; i < count; i += Isa::WIDTH) {
+    Isa::store(out + i, function(Isa::load(a + i)));
+  }
+}
+
+template <typename Isa, typename Function>
+void mapLanes(float *out, const float *a, const float *b, size_t count,
+              Function function) {
+  for (size_t i = 0; i < count; i += Isa::WIDTH) {
+    Isa::store(out + i, function(Isa::load(a + i), Isa::load(b + i)));
+  }
+}
+
+/**
+ * Runs bytecode over `count` lanes, Isa::WIDTH lanes per operation.
+ *
+ * Transcendental functions call into the C library for every lane instead of
+ * using vectorized approximations, so that all instruction sets produce the
+ * same results as the scalar interpreters.
+ */
+template <typename Isa>
+void executeBatch(const Instruction *begin, const Instruction *end,
+                  float *registers, size_t stride, size_t count) {
+  using V = typename Isa::Vector;
+
+  for (const Instruction *i = begin; i != end; ++i) {
+    float *out = registers + i->out * stride;
+    const float *a = registers + i->a * stride;
+    const float *b = registers + i->b * stride;
+
+    switch (i->op) {
+      case OpCode::SIN:
+        for (size_t j = 0; j < count; j++) out[j] = sinf(a[j]);
+        break;
+      case OpCode::COS:
+        for (size_t j = 0; j < count; j++) out[j] = cosf(a[j]);
+        break;
+      case OpCode::TAN:
+        for (size_t j = 0; j < count; j++) out[j] = tanf(a[j]);
+        break;
+      case OpCode::ATAN:
+        for (size_t j = 0; j < count; j++) out[j] = atanf(a[j]);
+        break;
+      case OpCode::EXP:
+        for (size_t j = 0; j < count; j++) out[j] = expf(a[j]);
+        break;
+      case OpCode::POWER:
+        for (size_t j = 0; j < count; j++) out[j] = powf(a[j], b[j]);
+        break;
+      case OpCode::MODULO:
+        for (size_t j = 0; j < count; j++) out[j] = fmodf(a[j], b[j]);
+        break;
+      case OpCode::MINUS:
+        mapLanes<Isa>(out, a, count, [](V x) { return Isa::minus(x); });
+        break;
+      case OpCode::SQRT:
+        mapLanes<Isa>(out, a, count, [](V x) { return Isa::sqrt(x); });
+        break;
+      case OpCode::TRUNC:
+        mapLanes<Isa>(out, a, count, [](V x) { return Isa::trunc(x); });
+        break;
+      case OpCode::FLOOR:
+        mapLanes<Isa>(out, a, count, [](V x) { return Isa::floor(x); });
+        break;
+      case OpCode::CEIL:
+        mapLanes<Isa>(out, a, count, [](V x) { return Isa::ceil(x); });
+        break;
+      case OpCode::SIGNUM:
+        mapLanes<Isa>(out, a, count, [](V x) { return Isa::signum(x); });
+        break;
+      case OpCode::ABS:
+        mapLanes<Isa>(out, a, count, [](V x) { return Isa::abs(x); });
+        break;
+      case OpCode::NOT:
+        mapLanes<Isa>(out, a, count, [](V x) { return Isa::logicalNot(x); });
+        break;
+      case OpCode::FRAC:
+        mapLanes<Isa>(out, a, count, [](V x) { return Isa::frac(x); });
+        break;
+      case OpCode::ADD:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::add(x, y); });
+        break;
+      case OpCode::SUBTRACT:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::subtract(x, y); });
+        break;
+      case OpCode::MULTIPLY:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::multiply(x, y); });
+        break;
+      case OpCode::DIVIDE:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::divide(x, y); });
+        break;
+      case OpCode::AND:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::logicalAnd(x, y); });
+        break;
+      case OpCode::OR:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::logicalOr(x, y); });
+        break;
+      case OpCode::LESS_THAN:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::lessThan(x, y); });
+        break;
+      case OpCode::GREATER_THAN:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::lessThan(y, x); });
+        break;
+      case OpCode::EQUALS:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::equals(x, y); });
+        break;
+      case OpCode::LESS_THAN_OR_EQUAL:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::lessThanOrEqual(x, y); });
+        break;
+      case OpCode::GREATER_THAN_OR_EQUAL:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::lessThanOrEqual(y, x); });
+        break;
+      case OpCode::DISTANCE:
+        mapLanes<Isa>(out, a, b, count,
+                      [](V x, V y) { return Isa::abs(Isa::subtract(x, y)); });
+        break;
+    }
+  }
+}
+
+#if defined(CHAOSKIT_X86_SIMD)
+BatchExecutor sse41BatchExecutor();
+BatchExecutor avx2BatchExecutor();
+#endif
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_SIMDEXECUTOR_H
@@ -0,0 +1,69 @@
+#include <smmintrin.h>
+#include "SimdExecutor.h"
+
+namespace chaoskit::core {
+
+namespace {
+
+struct Sse41 {
+  using Vector = __m128;
+  static constexpr size_t WIDTH = 4;
+
+  static Vector load(const float *p) { return _mm_loadu_ps(p); }
+  static void store(float *p, Vector v) { _mm_storeu_ps(p, v); }
+
+  static Vector signMask() { return _mm_set1_ps(-0.f); }
+  static Vector one() { return _mm_set1_ps(1.f); }
+  static Vector truth(Vector mask) { return _mm_and_ps(mask, one()); }
+
+  static Vector minus(Vector a) { return _mm_xor_ps(a, signMask()); }
+  static Vector sqrt(Vector a) { return _mm_sqrt_ps(a); }
+  static Vector trunc(Vector a) {
+    return _mm_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  }
+  static Vector floor(Vector a) {
+    return _mm_round_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+  }
+  static Vector ceil(Vector a) {
+    return _mm_round_ps(a, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC);
+  }
+  static Vector signum(Vector a) {
+    return _mm_or_ps(one(), _mm_and_ps(a, signMask()));
+  }
+  static Vector abs(Vector a) { return _mm_andnot_ps(signMask(), a); }
+  static Vector logicalNot(Vector a) {
+    return truth(_mm_cmpeq_ps(a, _mm_setzero_ps()));
+  }
+  static Vector frac(Vector a) {
+    // Same as modff(): infinities give zero and the sign always follows a.
+    Vector finite = _mm_cmpneq_ps(abs(a), _mm_set1_ps(INFINITY));
+    Vector difference = _mm_and_ps(_mm_sub_ps(a, trunc(a)), finite);
+    return _mm_or_ps(abs(difference), _mm_and_ps(a, signMask()));
+  }
+
+  static Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+  static Vector subtract(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+  static Vector multiply(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+  static Vector divide(Vector a, Vector b) { return _mm_div_ps(a, b); }
+  static Vector logicalAnd(Vector a, Vector b) {
+    Vector zero = _mm_setzero_ps();
+    return truth(_mm_and_ps(_mm_cmpneq_ps(a, zero), _mm_cmpneq_ps(b, zero)));
+  }
+  static Vector logicalOr(Vector a, Vector b) {
+    Vector zero = _mm_setzero_ps();
+    return truth(_mm_or_ps(_mm_cmpneq_ps(a, zero), _mm_cmpneq_ps(b, zero)));
+  }
+  static Vector lessThan(Vector a, Vector b) {
+    return truth(_mm_cmplt_ps(a, b));
+  }
+  static Vector equals(Vector a, Vector b) { return truth(_mm_cmpeq_ps(a, b)); }
+  static Vector lessThanOrEqual(Vector a, Vector b) {
+    return truth(_mm_cmple_ps(a, b));
+  }
+};
+
+}  // namespace
+
+BatchExecutor sse41BatchExecutor() { return &executeBatch<Sse41>; }
+
+}  // namespace chaoskit::core
@@ -1,19 +1,42 @@
 #include "SimpleHistogramGenerator.h"
+#include <limits>
+#include "Philox.h"
 #include "ThreadLocalRng.h"
+#include "optimize.h"
 #include "toSource.h"
 
 namespace chaoskit::core {
 
+namespace {
+
+constexpr uint64_t CHUNK_ITERATIONS =
+    SimpleHistogramGenerator::BATCH_SIZE *
+    SimpleHistogramGenerator::STEPS_PER_CHUNK;
+
+/** Number of rows reduced by a single task. */
+constexpr size_t REDUCTION_ROWS = 16;
+
+uint64_t randomSeed(Rng &rng) {
+  auto half = [&rng] {
+    return static_cast<uint32_t>(rng.randomInt(
+        std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+  };
+  uint64_t high = half();
+  return (high << 32) | half();
+}
+
+}  // namespace
+
 SimpleHistogramGenerator::SimpleHistogramGenerator(const System &system,
                                                    uint32_t width,
                                                    uint32_t height, int ttl,
                                                    std::shared_ptr<Rng> rng)
     : width_(width),
       height_(height),
-      buffer_(width * height),
+      histogram_(width, height),
       iteration_count_(stdx::nullopt),
-      interpreter_(toSource(system), ttl, Params::fromSystem(system)),
-      color_map_(nullptr),
+      interpreter_(optimize(toSource(system), Params::fromSystem(system)),
+                   BATCH_SIZE, ttl, Params::fromSystem(system)),
       rng_(std::move(rng)) {}
 
 SimpleHistogramGenerator::SimpleHistogramGenerator(const System &system,
@@ -23,8 +46,11 @@ SimpleHistogramGenerator::SimpleHistogramGenerator(const System &system,
                                std::make_shared<ThreadLocalRng>()) {}
 
 void SimpleHistogramGenerator::setSystem(const System &system) {
-  interpreter_.setSystem(toSource(system));
-  interpreter_.setParams(Params::fromSystem(system));
+  // Parameters are fixed for a whole render, so they can be baked into the
+  // code.
+  auto params = Params::fromSystem(system);
+  auto source = optimize(toSource(system), params);
+  interpreter_.setSystem(source, std::move(params));
 }
 
 void SimpleHistogramGenerator::setTtl(int ttl) { interpreter_.setTtl(ttl); }
@@ -32,8 +58,7 @@ void SimpleHistogramGenerator::setTtl(int ttl) { interpreter_.setTtl(ttl); }
 void SimpleHistogramGenerator::setSize(uint32_t width, uint32_t height) {
   width_ = width;
   height_ = height;
-  buffer_.resize(width * height);
-  clear();
+  histogram_.resize(width, height);
 }
 
 void SimpleHistogramGenerator::setIterationCount(uint32_t count) {
@@ -44,24 +69,121 @@ void SimpleHistogramGenerator::setInfiniteIterationCount() {
   iteration_count_ = stdx::nullopt;
 }
 
-void SimpleHistogramGenerator::setColorMap(const ColorMap *color_map) {
-  color_map_ = color_map;
+void SimpleHistogramGenerator::setThreadCount(size_t count) {
+  thread_count_ = std::max<size_t>(count, 1);
+}
+
+void SimpleHistogramGenerator::setScheduler(Scheduler &scheduler) {
+  scheduler_ = &scheduler;
 }
 
-void SimpleHistogramGenerator::clear() {
-  std::fill(buffer_.begin(), buffer_.end(), Color::zero());
+void SimpleHistogramGenerator::setBinning(bool enabled) {
+  binning_ = enabled;
+}
+
+void SimpleHistogramGenerator::setProgressCallback(ProgressCallback callback) {
+  progress_callback_ = std::move(callback);
+}
+
+void SimpleHistogramGenerator::setSeed(uint64_t seed) { seed_ = seed; }
+
+void SimpleHistogramGenerator::clear() { histogram_.clear(); }
+
+std::vector<Bin> SimpleHistogramGenerator::bins() const {
+  std::vector<Bin> result(histogram_.size());
+  for (size_t y = 0; y < height_; y++) {
+    histogram_.toBins(y, result.data() + y * width_);
+  }
+  return result;
 }
 
 void SimpleHistogramGenerator::run() {
-  auto particle = interpreter_.randomizeParticle();
+  uint64_t seed = seed_ ? *seed_ : randomSeed(*rng_);
+  uint64_t chunkCount =
+      iteration_count_
+          ? (*iteration_count_ + CHUNK_ITERATIONS - 1) / CHUNK_ITERATIONS
+          : std::numeric_limits<uint64_t>::max();
+
+  std::vector<Worker> workers(
+      thread_count_,
+      Worker{interpreter_, CountingHistogram(width_, height_), TileBinner()});
+  for (auto &worker : workers) {
+    worker.binner.resize(width_, height_);
+  }
 
-  for (size_t i = 0; !iteration_count_ || i < *iteration_count_; i++) {
-    auto [next_state, output] = interpreter_(particle);
-    particle = next_state;
-    add(output);
+  uint64_t iterations = 0;
+  for (uint64_t begin = 0; begin < chunkCount;) {
+    uint64_t end = begin + std::min<uint64_t>(chunkCount - begin,
+                                              thread_count_ *
+                                                  CHUNKS_PER_REDUCTION);
+
+    // Chunks are dealt round robin. Each one starts from its own particles
+    // and the shards only hold counts, so the result doesn't depend on which
+    // worker ran what.
+    TaskGroup group(*scheduler_);
+    for (size_t index = 0; index < thread_count_; index++) {
+      group.run([&, index, begin, end] {
+        for (uint64_t chunk = begin + index; chunk < end;
+             chunk += thread_count_) {
+          runChunk(workers[index], seed, chunk);
+        }
+        flushBinner(workers[index]);
+      });
+    }
+    group.wait();
+
+    reduce(workers);
+    for (uint64_t chunk = begin; chunk < end; chunk++) {
+      iterations += chunkSize(chunk);
+    }
+    if (progress_callback_) {
+      progress_callback_(iterations);
+    }
+    begin = end;
   }
 }
-void SimpleHistogramGenerator::add(const Particle &particle) {
+
+uint64_t SimpleHistogramGenerator::chunkSize(uint64_t chunk) const {
+  if (!iteration_count_) {
+    return CHUNK_ITERATIONS;
+  }
+  return std::min<uint64_t>(CHUNK_ITERATIONS,
+                            *iteration_count_ - chunk * CHUNK_ITERATIONS);
+}
+
+void SimpleHistogramGenerator::runChunk(Worker &worker, uint64_t seed,
+                                        uint64_t chunk) const {
+  worker.interpreter.setRng(std::make_shared<PhiloxRng>(seed, chunk));
+  worker.interpreter.randomizeParticles();
+  for (size_t step = 0; step < WARMUP_STEPS; step++) {
+    worker.interpreter.step();
+  }
+
+  uint64_t size = chunkSize(chunk);
+  for (uint64_t i = 0; i < size;) {
+    worker.interpreter.step();
+
+    const auto &output = worker.interpreter.output();
+    auto count = static_cast<size_t>(
+        std::min<uint64_t>(output.size(), size - i));
+    for (size_t j = 0; j < count; j++) {
+      add(worker, output[j]);
+    }
+    i += count;
+  }
+}
+
+void SimpleHistogramGenerator::reduce(std::vector<Worker> &workers) {
+  // Each row sums the shards in the same order, whichever thread runs it.
+  scheduler_->parallelFor(0, height_, REDUCTION_ROWS, [&](size_t y) {
+    for (auto &worker : workers) {
+      histogram_.takeRow(worker.shard, y);
+    }
+  });
+}
+
+void SimpleHistogramGenerator::add(Worker &worker,
+                                   const Particle &particle) const {
   float x = (particle.x() + 1.f) * (width_ * .5f);
   float y = (particle.y() + 1.f) * (height_ * .5f);
 
@@ -70,17 +192,22 @@ void SimpleHistogramGenerator::add(const Particle &particle) {
     return;
   }
 
-  add(static_cast<uint32_t>(x), static_cast<uint32_t>(y), particle.color);
-}
-
-void SimpleHistogramGenerator::add(uint32_t x, uint32_t y, float factor) {
-  auto &color = buffer_[y * width_ + x];
-
-  if (color_map_) {
-    color += color_map_->map(factor);
+  auto column = static_cast<uint32_t>(x);
+  auto row = static_cast<uint32_t>(y);
+  if (binning_) {
+    worker.binner.add(column, row, particle.color);
+    if (worker.binner.full()) {
+      flushBinner(worker);
+    }
   } else {
-    color += {1, 1, 1, factor};
+    worker.shard.add(column, row, particle.color);
   }
 }
 
+void SimpleHistogramGenerator::flushBinner(Worker &worker) const {
+  worker.binner.flush([&worker](uint32_t x, uint32_t y, float color) {
+    worker.shard.add(x, y, color);
+  });
+}
+
 }  // namespace chaoskit::core
@@ -2,17 +2,49 @@
 #define CHAOSKIT_CORE_SIMPLEHISTOGRAMGENERATOR_H
 
 #include <stdx/optional.h>
+#include <functional>
 #include <vector>
 
-#include "Color.h"
-#include "ColorMap.h"
-#include "SimpleInterpreter.h"
+#include "BatchInterpreter.h"
+#include "Bin.h"
+#include "CountingHistogram.h"
+#include "Scheduler.h"
+#include "TileBinner.h"
 #include "structures/System.h"
 
 namespace chaoskit::core {
 
+/**
+ * Renders a system into a histogram, optionally on several threads.
+ *
+ * Iterations are split into chunks of BATCH_SIZE * STEPS_PER_CHUNK, and
+ * chunk `i` draws its random numbers from stream `i` of the seed. Every chunk
+ * starts from its own random particles, warmed up for WARMUP_STEPS, so what
+ * it adds only depends on the seed and `i`, not on which worker runs it.
+ * Workers add their chunks to private shards of the histogram; shards are
+ * added to the output after every CHUNKS_PER_REDUCTION chunks per worker and
+ * at the end of run().
+ *
+ * Samples are counted exactly with a CountingHistogram, so that long renders
+ * keep converging however many samples they take.
+ */
 class SimpleHistogramGenerator {
  public:
+  /** Number of trajectories that are followed at the same time. */
+  static constexpr size_t BATCH_SIZE = 256;
+  /** Number of batch steps in a chunk. */
+  static constexpr size_t STEPS_PER_CHUNK = 256;
+  /**
+   * Number of batch steps each chunk takes before adding anything, so that
+   * its particles reach the attractor first.
+   */
+  static constexpr size_t WARMUP_STEPS = 16;
+  /** Number of chunks each thread runs between two reductions. */
+  static constexpr size_t CHUNKS_PER_REDUCTION = 16;
+
+  /** Called after each reduction with the number of iterations done. */
+  using ProgressCallback = std::function<void(uint64_t iterations)>;
+
   SimpleHistogramGenerator(const System &system, uint32_t width,
                            uint32_t height, int ttl, std::shared_ptr<Rng> rng);
   SimpleHistogramGenerator(const System &system, uint32_t width,
@@ -21,25 +53,57 @@ class SimpleHistogramGenerator {
   void setSystem(const System &system);
   void setSize(uint32_t width, uint32_t height);
   void setTtl(int ttl);
-  void setColorMap(const ColorMap *color_map);
   void setIterationCount(uint32_t count);
   void setInfiniteIterationCount();
+  /**
+   * Sets the number of workers, each with its own particles and shard. They
+   * run as tasks of the scheduler, Scheduler::shared() by default.
+   */
+  void setThreadCount(size_t count);
+  void setScheduler(Scheduler &scheduler);
+  /**
+   * Makes workers sort their samples by tile before adding them, which pays
+   * off on histograms too large to stay in cache. Off by default.
+   */
+  void setBinning(bool enabled);
+  void setProgressCallback(ProgressCallback callback);
 
-  [[nodiscard]] const Color *data() const { return buffer_.data(); }
+  /**
+   * Makes run() deterministic: every run with the same seed, system and
+   * settings produces the same histogram, whatever the thread count. Without
+   * a seed, every run() picks a new one from the Rng.
+   */
+  void setSeed(uint64_t seed);
+
+  /** Converts the histogram to bins, to be colored with colorize(). */
+  [[nodiscard]] std::vector<Bin> bins() const;
 
   void clear();
   void run();
 
  private:
+  struct Worker {
+    BatchInterpreter interpreter;
+    CountingHistogram shard;
+    TileBinner binner;
+  };
+
   uint32_t width_, height_;
-  std::vector<Color> buffer_;
+  CountingHistogram histogram_;
   stdx::optional<uint32_t> iteration_count_;
-  SimpleInterpreter interpreter_;
-  const ColorMap *color_map_;
+  BatchInterpreter interpreter_;
   std::shared_ptr<Rng> rng_;
+  stdx::optional<uint64_t> seed_;
+  size_t thread_count_ = 1;
+  bool binning_ = false;
+  Scheduler *scheduler_ = &Scheduler::shared();
+  ProgressCallback progress_callback_;
 
-  void add(const Particle &particle);
-  void add(uint32_t x, uint32_t y, float factor = 1);
+  [[nodiscard]] uint64_t chunkSize(uint64_t chunk) const;
+  void runChunk(Worker &worker, uint64_t seed, uint64_t chunk) const;
+  void reduce(std::vector<Worker> &workers);
+  void add(Worker &worker, const Particle &particle) const;
+  void flushBinner(Worker &worker) const;
 };
 
 }  // namespace chaoskit::core
@@ -0,0 +1,134 @@
+#include <gmock/gmock.h>
+
+#include "SimpleHistogramGenerator.h"
+#include "ast/helpers.h"
+
+namespace chaoskit::core {
+
+using testing::ElementsAre;
+using testing::Eq;
+
+class SimpleHistogramGeneratorTest : public testing::Test {
+ protected:
+  static constexpr uint32_t SIZE = 64;
+
+  Formula formula_;
+  Blend blend_;
+  FinalBlend finalBlend_;
+  System system_;
+
+  void SetUp() override {
+    // Swapping coordinates keeps every particle inside the histogram.
+    ast::helpers::InputHelper input;
+    formula_.source = ast::Formula{input.y(), input.x()};
+    blend_.formulas.push_back(&formula_);
+    system_.blends.push_back(&blend_);
+    system_.finalBlend = &finalBlend_;
+  }
+
+  static double total(const SimpleHistogramGenerator &generator) {
+    double result = 0.;
+    for (const auto &bin : generator.bins()) {
+      result += bin.density;
+    }
+    return result;
+  }
+
+  static std::vector<float> densities(
+      const SimpleHistogramGenerator &generator) {
+    std::vector<float> result;
+    for (const auto &bin : generator.bins()) {
+      result.push_back(bin.density);
+    }
+    return result;
+  }
+
+  static std::vector<float> colors(const SimpleHistogramGenerator &generator) {
+    std::vector<float> result;
+    for (const auto &bin : generator.bins()) {
+      result.push_back(bin.color);
+    }
+    return result;
+  }
+};
+
+TEST_F(SimpleHistogramGeneratorTest, RunsRequestedIterations) {
+  SimpleHistogramGenerator generator(system_, SIZE, SIZE);
+  generator.setIterationCount(100000);
+
+  generator.run();
+
+  ASSERT_THAT(total(generator), Eq(100000.));
+}
+
+TEST_F(SimpleHistogramGeneratorTest, RunsRequestedIterationsOnThreads) {
+  SimpleHistogramGenerator generator(system_, SIZE, SIZE);
+  generator.setIterationCount(1000000);
+  generator.setThreadCount(4);
+
+  generator.run();
+
+  ASSERT_THAT(total(generator), Eq(1000000.));
+}
+
+TEST_F(SimpleHistogramGeneratorTest, ReportsProgress) {
+  SimpleHistogramGenerator generator(system_, SIZE, SIZE);
+  constexpr uint64_t perReduction =
+      2 * SimpleHistogramGenerator::CHUNKS_PER_REDUCTION *
+      SimpleHistogramGenerator::STEPS_PER_CHUNK *
+      SimpleHistogramGenerator::BATCH_SIZE;
+  generator.setIterationCount(perReduction + 10);
+  generator.setThreadCount(2);
+  std::vector<uint64_t> progress;
+  generator.setProgressCallback(
+      [&progress](uint64_t iterations) { progress.push_back(iterations); });
+
+  generator.run();
+
+  ASSERT_THAT(progress, ElementsAre(perReduction, perReduction + 10));
+}
+
+TEST_F(SimpleHistogramGeneratorTest, SeededRunsAreReproducible) {
+  SimpleHistogramGenerator first(system_, SIZE, SIZE);
+  SimpleHistogramGenerator second(system_, SIZE, SIZE);
+  for (auto *generator : {&first, &second}) {
+    generator->setIterationCount(200000);
+    generator->setThreadCount(3);
+    generator->setSeed(42);
+    generator->run();
+  }
+
+  ASSERT_THAT(colors(first), Eq(colors(second)));
+}
+
+TEST_F(SimpleHistogramGeneratorTest, IsIndependentOfThreadCount) {
+  SimpleHistogramGenerator single(system_, SIZE, SIZE);
+  SimpleHistogramGenerator threaded(system_, SIZE, SIZE);
+  single.setThreadCount(1);
+  threaded.setThreadCount(3);
+  for (auto *generator : {&single, &threaded}) {
+    generator->setIterationCount(200000);
+    generator->setSeed(42);
+    generator->run();
+  }
+
+  ASSERT_THAT(densities(threaded), Eq(densities(single)));
+  ASSERT_THAT(colors(threaded), Eq(colors(single)));
+}
+
+TEST_F(SimpleHistogramGeneratorTest, BinningKeepsHistogram) {
+  SimpleHistogramGenerator plain(system_, SIZE, SIZE);
+  SimpleHistogramGenerator binned(system_, SIZE, SIZE);
+  binned.setBinning(true);
+  for (auto *generator : {&plain, &binned}) {
+    generator->setIterationCount(200000);
+    generator->setThreadCount(2);
+    generator->setSeed(42);
+    generator->run();
+  }
+
+  ASSERT_THAT(colors(binned), Eq(colors(plain)));
+  ASSERT_THAT(total(binned), Eq(200000.));
+}
+
+}  // namespace chaoskit::core
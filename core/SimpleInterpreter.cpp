@@ -7,7 +7,7 @@
 
 #include "ThreadLocalRng.h"
 #include "ast/ast.h"
-#include "errors.h"
+#include "optimize.h"
 
 namespace chaoskit::core {
 
@@ -56,11 +56,12 @@ const std::unordered_map<char, std::function<float(float, float)>>
 
 class BlendInterpreter {
  public:
-  BlendInterpreter(Particle input, const Params &params, size_t blend_index)
+  BlendInterpreter(Particle input, const CompiledParams &params,
+                   size_t blend_index)
       : input_(input),
         output_(input),
-        params_(params),
-        index_{blend_index, 0} {}
+        index_{blend_index, 0},
+        params_(params) {}
 
   float operator()(float number) const { return number; }
 
@@ -85,11 +86,7 @@ class BlendInterpreter {
   }
 
   float operator()(const ast::Parameter &param) const {
-    try {
-      return params_.at(index_).at(param.index());
-    } catch (std::out_of_range &e) {
-      throw MissingParameterError(index_, param.index());
-    }
+    return values_[param.index()];
   }
 
   float operator()(const ast::UnaryFunction &function) const {
@@ -104,6 +101,10 @@ class BlendInterpreter {
   }
 
   Particle operator()(const ast::Transform &transform) const {
+    if (transform == ast::Transform::identity()) {
+      return output_;
+    }
+
     const auto &point = output_.point;
     const auto &params = transform.params();
     return outputWithPoint(
@@ -129,6 +130,7 @@ class BlendInterpreter {
     if (!blend.formulas().empty()) {
       Point point;
       for (const auto &formula : blend.formulas()) {
+        values_ = params_.at(index_);
         point += (*this)(formula).point;
         index_.formula++;
       }
@@ -137,6 +139,7 @@ class BlendInterpreter {
 
     output_ = (*this)(blend.post());
     index_.formula = SystemIndex::COLORING_METHOD;
+    values_ = params_.at(index_);
     output_.color = apply_visitor(*this, blend.coloringMethod());
     return output_;
   }
@@ -144,7 +147,8 @@ class BlendInterpreter {
  private:
   Particle input_, output_;
   SystemIndex index_;
-  const Params &params_;
+  const CompiledParams &params_;
+  const float *values_ = nullptr;
 
   [[nodiscard]] Particle outputWithPoint(Point point) const {
     return {point, output_.color, output_.ttl};
@@ -155,19 +159,25 @@ class BlendInterpreter {
 
 SimpleInterpreter::SimpleInterpreter(ast::System system, int ttl, Params params,
                                      std::shared_ptr<Rng> rng)
-    : system_(std::move(system)),
+    : system_(optimize(system)),
       ttl_(ttl),
       params_(std::move(params)),
+      compiled_params_(system_, params_),
       rng_(std::move(rng)) {
-  updateMaxLimit();
+  updateBlendTable();
 }
 
 SimpleInterpreter::SimpleInterpreter(ast::System system, int ttl, Params params)
     : SimpleInterpreter(std::move(system), ttl, std::move(params),
                         std::make_shared<ThreadLocalRng>()) {}
 
-void SimpleInterpreter::updateMaxLimit() {
-  max_limit_ = system_.blends().empty() ? 0 : system_.blends().back().limit();
+void SimpleInterpreter::updateBlendTable() {
+  std::vector<float> limits;
+  limits.reserve(system_.blends().size());
+  for (const auto &blend : system_.blends()) {
+    limits.push_back(blend.limit());
+  }
+  blend_table_ = AliasTable(limits);
 }
 
 Particle SimpleInterpreter::randomizeParticle() {
@@ -185,11 +195,22 @@ void SimpleInterpreter::randomizeParticle(Particle &particle) {
 }
 
 void SimpleInterpreter::setSystem(const ast::System &system) {
-  system_ = system;
-  updateMaxLimit();
+  auto optimized = optimize(system);
+  compiled_params_ = CompiledParams(optimized, params_);
+  system_ = std::move(optimized);
+  updateBlendTable();
+}
+
+void SimpleInterpreter::setSystem(const ast::System &system, Params params) {
+  auto optimized = optimize(system);
+  compiled_params_ = CompiledParams(optimized, params);
+  system_ = std::move(optimized);
+  params_ = std::move(params);
+  updateBlendTable();
 }
 
 void SimpleInterpreter::setParams(Params params) {
+  compiled_params_ = CompiledParams(system_, params);
   params_ = std::move(params);
 }
 
@@ -204,25 +225,19 @@ SimpleInterpreter::Result SimpleInterpreter::operator()(Particle input) {
   }
 
   if (!system_.blends().empty()) {
-    float limit = rng_->randomFloat(0.f, max_limit_);
-    auto blend_iterator = std::lower_bound(
-        system_.blends().begin(), system_.blends().end(), limit,
-        [](const ast::LimitedBlend &blend, float limit) {
-          return blend.limit() < limit;
-        });
-    auto blend_index = static_cast<size_t>(
-        std::distance(system_.blends().begin(), blend_iterator));
-
-    next_state = BlendInterpreter(next_state, params_,
-                                  blend_index)(blend_iterator->blend());
+    size_t blend_index = blend_table_.sample(*rng_);
+    next_state =
+        BlendInterpreter(next_state, compiled_params_,
+                         blend_index)(system_.blends()[blend_index].blend());
   }
 
   if (next_state.ttl != Particle::IMMORTAL) {
     --next_state.ttl;
   }
 
-  Particle output = BlendInterpreter(
-      next_state, params_, SystemIndex::FINAL_BLEND)(system_.final_blend());
+  Particle output =
+      BlendInterpreter(next_state, compiled_params_,
+                       SystemIndex::FINAL_BLEND)(system_.final_blend());
 
   return {next_state, output};
 }
@@ -2,12 +2,20 @@
 #define CHAOSKIT_CORE_SIMPLEINTERPRETER_H
 
 #include <ast/System.h>
+#include "AliasTable.h"
+#include "CompiledParams.h"
 #include "Params.h"
 #include "Particle.h"
 #include "Rng.h"
 
 namespace chaoskit::core {
 
+/**
+ * Walks the AST of a system on every iteration.
+ *
+ * Missing parameters are reported by throwing MissingParameterError as soon
+ * as a system or parameters are set, never while iterating.
+ */
 class SimpleInterpreter {
  public:
   struct Result {
@@ -25,6 +33,7 @@ class SimpleInterpreter {
                     std::shared_ptr<Rng> rng);
 
   void setSystem(const ast::System &system);
+  void setSystem(const ast::System &system, Params params);
   void setParams(Params params);
   void setTtl(int ttl);
   Particle randomizeParticle();
@@ -34,10 +43,11 @@ class SimpleInterpreter {
   ast::System system_;
   int ttl_;
   Params params_;
-  float max_limit_;
+  CompiledParams compiled_params_;
+  AliasTable blend_table_;
   std::shared_ptr<Rng> rng_;
 
-  void updateMaxLimit();
+  void updateBlendTable();
   void randomizeParticle(Particle &particle);
 };
 
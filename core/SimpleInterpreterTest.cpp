@@ -74,4 +74,11 @@ TEST_F(SimpleInterpreterTest, UsesOutput) {
               Eq(SimpleInterpreter::Result{output, output}));
 }
 
+TEST_F(SimpleInterpreterTest, ThrowsOnMissingParameter) {
+  ast::helpers::ParameterHelper params;
+  auto system = make_system(ast::Formula{params[0], params[1]});
+
+  ASSERT_THROW(SimpleInterpreter{system}, MissingParameterError);
+}
+
 }  // namespace chaoskit::core
@@ -0,0 +1,100 @@
+#ifndef CHAOSKIT_CORE_SPSCRING_H
+#define CHAOSKIT_CORE_SPSCRING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace chaoskit::core {
+
+/**
+ * A bounded lock-free queue between exactly one producer thread and one
+ * consumer thread, moving items in bulk.
+ *
+ * Each side only writes its own index and keeps a copy of the other one, so
+ * in the common case a call touches no cache line owned by the other thread
+ * except to publish what it did.
+ */
+template <typename T>
+class SpscRing {
+ public:
+  /** The capacity is rounded up to a power of two. */
+  explicit SpscRing(size_t capacity) : buffer_(roundUp(capacity)) {}
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  [[nodiscard]] size_t capacity() const { return buffer_.size(); }
+
+  /**
+   * Appends up to `count` items and returns how many fit. Only the producer
+   * may call it.
+   */
+  size_t push(const T *items, size_t count) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (capacity() - (head - cached_tail_) < count) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    count = std::min(count, capacity() - (head - cached_tail_));
+
+    size_t start = head & (capacity() - 1);
+    size_t first = std::min(count, capacity() - start);
+    std::copy(items, items + first, buffer_.begin() + start);
+    std::copy(items + first, items + count, buffer_.begin());
+
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * Removes up to `count` items into `out` and returns how many there were.
+   * Only the consumer may call it.
+   */
+  size_t pop(T *out, size_t count) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (cached_head_ - tail < count) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    count = std::min(count, cached_head_ - tail);
+
+    size_t start = tail & (capacity() - 1);
+    size_t first = std::min(count, capacity() - start);
+    std::copy(buffer_.begin() + start, buffer_.begin() + start + first, out);
+    std::copy(buffer_.begin(), buffer_.begin() + (count - first),
+              out + first);
+
+    tail_.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  /** Number of queued items. Exact only when both sides are idle. */
+  [[nodiscard]] size_t size() const {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  std::vector<T> buffer_;
+
+  /** Index of the next item to write, owned by the producer. */
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+  size_t cached_tail_ = 0;
+
+  /** Index of the next item to read, owned by the consumer. */
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+  size_t cached_head_ = 0;
+
+  static size_t roundUp(size_t capacity) {
+    size_t result = 1;
+    while (result < capacity) {
+      result <<= 1;
+    }
+    return result;
+  }
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_SPSCRING_H
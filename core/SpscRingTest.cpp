@@ -0,0 +1,82 @@
+#include <gmock/gmock.h>
+
+#include <numeric>
+#include <thread>
+#include "SpscRing.h"
+
+namespace chaoskit::core {
+
+using testing::ElementsAre;
+using testing::Eq;
+
+class SpscRingTest : public testing::Test {};
+
+TEST_F(SpscRingTest, RoundsCapacityUp) {
+  SpscRing<int> ring(5);
+
+  ASSERT_THAT(ring.capacity(), Eq(8u));
+}
+
+TEST_F(SpscRingTest, PushesOnlyWhatFits) {
+  SpscRing<int> ring(4);
+  int items[] = {1, 2, 3, 4, 5, 6};
+
+  ASSERT_THAT(ring.push(items, 6), Eq(4u));
+  ASSERT_THAT(ring.size(), Eq(4u));
+}
+
+TEST_F(SpscRingTest, WrapsAround) {
+  SpscRing<int> ring(4);
+  int items[] = {1, 2, 3, 4, 5};
+  int out[4] = {};
+
+  ring.push(items, 3);
+  ring.pop(out, 2);
+  ring.push(items + 3, 2);
+
+  ASSERT_THAT(ring.pop(out, 4), Eq(3u));
+  ASSERT_THAT(out, ElementsAre(3, 4, 5, 0));
+}
+
+TEST_F(SpscRingTest, PopsNothingWhenEmpty) {
+  SpscRing<int> ring(4);
+  int out[1];
+
+  ASSERT_THAT(ring.pop(out, 1), Eq(0u));
+}
+
+TEST_F(SpscRingTest, KeepsOrderAcrossThreads) {
+  constexpr int COUNT = 100000;
+  SpscRing<int> ring(1024);
+
+  std::thread producer([&ring] {
+    int items[100];
+    for (int next = 0; next < COUNT;) {
+      int count = std::min(100, COUNT - next);
+      std::iota(items, items + count, next);
+      for (int pushed = 0; pushed < count;) {
+        pushed += static_cast<int>(ring.push(items + pushed, count - pushed));
+        std::this_thread::yield();
+      }
+      next += count;
+    }
+  });
+
+  int expected = 0;
+  bool ordered = true;
+  int out[64];
+  while (expected < COUNT) {
+    size_t count = ring.pop(out, 64);
+    if (count == 0) {
+      std::this_thread::yield();
+    }
+    for (size_t i = 0; i < count; i++) {
+      ordered = ordered && out[i] == expected++;
+    }
+  }
+  producer.join();
+
+  ASSERT_TRUE(ordered);
+}
+
+}  // namespace chaoskit::core
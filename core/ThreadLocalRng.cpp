@@ -1,19 +1,23 @@
 #include "ThreadLocalRng.h"
 
-#include "randutils.hpp"
+#include "Xoshiro128.h"
 
 namespace chaoskit::core {
 
 namespace {
-thread_local randutils::mt19937_rng rng;
+thread_local Xoshiro128 rng;
 }
 
 float ThreadLocalRng::randomFloat(float min, float max) {
-  return rng.uniform(min, max);
+  return rng.randomFloat(min, max);
 }
 
 int ThreadLocalRng::randomInt(int min, int max) {
-  return rng.uniform(min, max);
+  return rng.randomInt(min, max);
+}
+
+void ThreadLocalRng::fill(float *out, size_t count, float min, float max) {
+  rng.fill(out, count, min, max);
 }
 
 }  // namespace chaoskit::core
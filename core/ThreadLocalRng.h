@@ -5,10 +5,12 @@
 
 namespace chaoskit::core {
 
+/** Shares one Xoshiro128 per thread between all instances. */
 class ThreadLocalRng : public Rng {
  public:
   float randomFloat(float min, float max) override;
   int randomInt(int min, int max) override;
+  void fill(float *out, size_t count, float min, float max) override;
 };
 
 }  // namespace chaoskit::core
@@ -0,0 +1,25 @@
+#include "TileBinner.h"
+#include <numeric>
+
+namespace chaoskit::core {
+
+void TileBinner::resize(size_t width, size_t height) {
+  tileColumns_ = (width + TILE_SIZE - 1) / TILE_SIZE;
+  tileCount_ = tileColumns_ * ((height + TILE_SIZE - 1) / TILE_SIZE);
+}
+
+const std::vector<TileBinner::Sample> &TileBinner::sort() {
+  offsets_.assign(tileCount_ + 1, 0);
+  for (const auto &sample : samples_) {
+    ++offsets_[tileOf(sample) + 1];
+  }
+  std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+
+  sorted_.resize(samples_.size());
+  for (const auto &sample : samples_) {
+    sorted_[offsets_[tileOf(sample)]++] = sample;
+  }
+  return sorted_;
+}
+
+}  // namespace chaoskit::core
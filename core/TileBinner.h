@@ -0,0 +1,71 @@
+#ifndef CHAOSKIT_CORE_TILEBINNER_H
+#define CHAOSKIT_CORE_TILEBINNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "HistogramBuffer.h"
+
+namespace chaoskit::core {
+
+/**
+ * Groups samples by the histogram tile they fall in, so that adding them
+ * walks a large histogram one tile at a time instead of jumping all over it.
+ *
+ * Samples are queued until flush(), which counting-sorts them by tile, of
+ * the same size as HistogramBuffer tiles, and hands them over in that order.
+ * The sort is stable, so samples of a pixel keep their order.
+ */
+class TileBinner {
+ public:
+  static constexpr size_t TILE_SIZE = HistogramBuffer::TILE_SIZE;
+  /** Number of samples queued before full() says so. */
+  static constexpr size_t DEFAULT_CAPACITY = 1 << 18;
+
+  struct Sample {
+    uint32_t x, y;
+    float color;
+  };
+
+  explicit TileBinner(size_t capacity = DEFAULT_CAPACITY)
+      : capacity_(capacity) {}
+
+  /** Sets the size of the histogram. Queued samples must fit in it. */
+  void resize(size_t width, size_t height);
+
+  /** Queues a sample, which has to be inside the histogram. */
+  void add(uint32_t x, uint32_t y, float color) {
+    samples_.push_back({x, y, color});
+  }
+
+  [[nodiscard]] bool empty() const { return samples_.empty(); }
+  [[nodiscard]] bool full() const { return samples_.size() >= capacity_; }
+  /** Drops the queued samples. */
+  void clear() { samples_.clear(); }
+
+  /** Calls `sink(x, y, color)` with every queued sample, tile by tile. */
+  template <typename Sink>
+  void flush(Sink sink) {
+    for (const auto &sample : sort()) {
+      sink(sample.x, sample.y, sample.color);
+    }
+    samples_.clear();
+  }
+
+ private:
+  size_t capacity_;
+  size_t tileColumns_ = 0;
+  size_t tileCount_ = 0;
+  std::vector<Sample> samples_;
+  std::vector<Sample> sorted_;
+  std::vector<uint32_t> offsets_;
+
+  [[nodiscard]] size_t tileOf(const Sample &sample) const {
+    return (sample.y / TILE_SIZE) * tileColumns_ + sample.x / TILE_SIZE;
+  }
+  const std::vector<Sample> &sort();
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_TILEBINNER_H
@@ -0,0 +1,74 @@
+#include <gmock/gmock.h>
+
+#include <vector>
+#include "TileBinner.h"
+
+namespace chaoskit::core {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+class TileBinnerTest : public testing::Test {
+ protected:
+  static constexpr uint32_t TILE = TileBinner::TILE_SIZE;
+
+  static std::vector<float> flushColors(TileBinner &binner) {
+    std::vector<float> colors;
+    binner.flush(
+        [&](uint32_t, uint32_t, float color) { colors.push_back(color); });
+    return colors;
+  }
+};
+
+TEST_F(TileBinnerTest, HandsSamplesOverTileByTile) {
+  TileBinner binner;
+  binner.resize(2 * TILE, 2 * TILE);
+
+  binner.add(TILE, TILE, 3.f);
+  binner.add(TILE, 0, 1.f);
+  binner.add(0, TILE, 2.f);
+  binner.add(1, 1, 0.f);
+
+  ASSERT_THAT(flushColors(binner), ElementsAre(0.f, 1.f, 2.f, 3.f));
+}
+
+TEST_F(TileBinnerTest, KeepsOrderWithinTile) {
+  TileBinner binner;
+  binner.resize(2 * TILE, TILE);
+
+  binner.add(1, 1, 0.f);
+  binner.add(TILE, 0, 1.f);
+  binner.add(1, 1, 2.f);
+
+  ASSERT_THAT(flushColors(binner), ElementsAre(0.f, 2.f, 1.f));
+}
+
+TEST_F(TileBinnerTest, PassesCoordinatesThrough) {
+  TileBinner binner;
+  binner.resize(TILE, TILE);
+  binner.add(3, 5, 0.f);
+
+  std::vector<uint32_t> coordinates;
+  binner.flush([&](uint32_t x, uint32_t y, float) {
+    coordinates.push_back(x);
+    coordinates.push_back(y);
+  });
+
+  ASSERT_THAT(coordinates, ElementsAre(3u, 5u));
+}
+
+TEST_F(TileBinnerTest, EmptiesOnFlush) {
+  TileBinner binner(2);
+  binner.resize(TILE, TILE);
+
+  binner.add(0, 0, 0.f);
+  ASSERT_FALSE(binner.full());
+  binner.add(0, 0, 0.f);
+  ASSERT_TRUE(binner.full());
+
+  flushColors(binner);
+  ASSERT_TRUE(binner.empty());
+  ASSERT_THAT(flushColors(binner), IsEmpty());
+}
+
+}  // namespace chaoskit::core
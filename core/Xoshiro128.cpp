@@ -0,0 +1,37 @@
+#include "Xoshiro128.h"
+
+#include <iterator>
+#include "randutils.hpp"
+
+namespace chaoskit::core {
+
+namespace {
+
+uint64_t splitMix64(uint64_t &state) {
+  uint64_t z = (state += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+}  // namespace
+
+Xoshiro128::Xoshiro128() {
+  randutils::auto_seed_128 seed;
+  seed.generate(std::begin(s_), std::end(s_));
+  // The all-zero state is the only one the generator never leaves.
+  if ((s_[0] | s_[1] | s_[2] | s_[3]) == 0) {
+    s_[0] = 1;
+  }
+}
+
+Xoshiro128::Xoshiro128(uint64_t seed) {
+  uint64_t a = splitMix64(seed);
+  uint64_t b = splitMix64(seed);
+  s_[0] = static_cast<uint32_t>(a);
+  s_[1] = static_cast<uint32_t>(a >> 32);
+  s_[2] = static_cast<uint32_t>(b);
+  s_[3] = static_cast<uint32_t>(b >> 32);
+}
+
+}  // namespace chaoskit::core
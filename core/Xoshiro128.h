@@ -0,0 +1,63 @@
+#ifndef CHAOSKIT_CORE_XOSHIRO128_H
+#define CHAOSKIT_CORE_XOSHIRO128_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "uniform.h"
+
+namespace chaoskit::core {
+
+/**
+ * xoshiro128+ by David Blackman and Sebastiano Vigna: a small, fast generator
+ * whose upper bits are well suited for producing floats.
+ *
+ * Meets the requirements of UniformRandomBitGenerator, and also exposes the
+ * Rng methods without any virtual call, so that it can be bound as a template
+ * parameter.
+ */
+class Xoshiro128 {
+ public:
+  using result_type = uint32_t;
+
+  /** Seeds the generator from system entropy. */
+  Xoshiro128();
+  explicit Xoshiro128(uint64_t seed);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    uint32_t result = s_[0] + s_[3];
+    uint32_t t = s_[1] << 9;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = (s_[3] << 11) | (s_[3] >> 21);
+    return result;
+  }
+
+  /** Returns a number in [min; max). */
+  float randomFloat(float min, float max) {
+    return min + (max - min) * unitFloat((*this)());
+  }
+
+  /** Returns a number in [min; max]. */
+  int randomInt(int min, int max) { return uniformInt(*this, min, max); }
+
+  /** Fills `out` with `count` numbers in [min; max). */
+  void fill(float *out, size_t count, float min, float max) {
+    fillUniform(*this, out, count, min, max);
+  }
+
+ private:
+  uint32_t s_[4];
+};
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_XOSHIRO128_H
@@ -0,0 +1,74 @@
+#include <gmock/gmock.h>
+
+#include "FastRng.h"
+#include "Xoshiro128.h"
+
+namespace chaoskit::core {
+
+using testing::AllOf;
+using testing::Each;
+using testing::FloatEq;
+using testing::ElementsAre;
+using testing::Ge;
+using testing::Lt;
+using testing::Pointwise;
+
+class Xoshiro128Test : public testing::Test {};
+
+TEST_F(Xoshiro128Test, MatchesReferenceSequence) {
+  Xoshiro128 rng(42);
+
+  std::vector<uint32_t> values{rng(), rng(), rng(), rng()};
+
+  ASSERT_THAT(values,
+              ElementsAre(0x58db51c8u, 0x815c6c29u, 0xec0a8dcfu, 0xa5de31d4u));
+}
+
+TEST_F(Xoshiro128Test, FloatsStayInRange) {
+  Xoshiro128 rng(1);
+
+  std::vector<float> values;
+  for (int i = 0; i < 10000; i++) {
+    values.push_back(rng.randomFloat(-2.f, 3.f));
+  }
+
+  ASSERT_THAT(values, Each(AllOf(Ge(-2.f), Lt(3.f))));
+}
+
+TEST_F(Xoshiro128Test, IntsCoverInclusiveRange) {
+  Xoshiro128 rng(2);
+
+  std::vector<int> counts(5);
+  for (int i = 0; i < 10000; i++) {
+    int value = rng.randomInt(-2, 2);
+    ASSERT_THAT(value, AllOf(Ge(-2), Lt(3)));
+    counts[value + 2]++;
+  }
+
+  ASSERT_THAT(counts, Each(AllOf(Ge(1800), Lt(2200))));
+}
+
+TEST_F(Xoshiro128Test, FillMatchesSingleDraws) {
+  Xoshiro128 bulk(3);
+  Xoshiro128 single(3);
+
+  std::vector<float> filled(150);
+  bulk.fill(filled.data(), filled.size(), -1.f, 1.f);
+  std::vector<float> drawn;
+  for (size_t i = 0; i < filled.size(); i++) {
+    drawn.push_back(single.randomFloat(-1.f, 1.f));
+  }
+
+  ASSERT_THAT(filled, Pointwise(FloatEq(), drawn));
+}
+
+TEST_F(Xoshiro128Test, FastRngForwardsToGenerator) {
+  Xoshiro128 generator(4);
+  FastRng rng(4);
+  Rng &base = rng;
+
+  ASSERT_FLOAT_EQ(base.randomFloat(0.f, 1.f), generator.randomFloat(0.f, 1.f));
+  ASSERT_EQ(base.randomInt(0, 100), generator.randomInt(0, 100));
+}
+
+}  // namespace chaoskit::core
@@ -0,0 +1,54 @@
+#include "colorize.h"
+#include <algorithm>
+
+namespace chaoskit::core {
+
+namespace {
+
+/** Number of bins whose colors are mapped with one call. */
+constexpr size_t CHUNK_SIZE = 256;
+
+float averageColor(const Bin &bin) {
+  return bin.density > 0.f ? std::clamp(bin.color / bin.density, 0.f, 1.f)
+                           : 0.f;
+}
+
+void scale(Color &color, const Bin &bin) {
+  if (bin.density > 0.f) {
+    color *= bin.density;
+  } else {
+    color = Color::zero();
+  }
+}
+
+}  // namespace
+
+Color colorize(const Bin &bin, const ColorMap *colorMap) {
+  Color color = colorMap ? colorMap->map(averageColor(bin)) : Color(1.f);
+  scale(color, bin);
+  return color;
+}
+
+void colorize(const Bin *bins, size_t count, const ColorMap *colorMap,
+              Color *output) {
+  if (!colorMap) {
+    for (size_t i = 0; i < count; i++) {
+      output[i] = colorize(bins[i], nullptr);
+    }
+    return;
+  }
+
+  float colors[CHUNK_SIZE];
+  for (size_t begin = 0; begin < count; begin += CHUNK_SIZE) {
+    size_t size = std::min(CHUNK_SIZE, count - begin);
+    for (size_t i = 0; i < size; i++) {
+      colors[i] = averageColor(bins[begin + i]);
+    }
+    colorMap->mapMany(colors, size, output + begin);
+    for (size_t i = 0; i < size; i++) {
+      scale(output[begin + i], bins[begin + i]);
+    }
+  }
+}
+
+}  // namespace chaoskit::core
@@ -0,0 +1,21 @@
+#ifndef CHAOSKIT_CORE_COLORIZE_H
+#define CHAOSKIT_CORE_COLORIZE_H
+
+#include <cstddef>
+#include "Bin.h"
+#include "Color.h"
+#include "ColorMap.h"
+
+namespace chaoskit::core {
+
+/**
+ * The color of a bin: its average color coordinate mapped through
+ * `colorMap`, or white without one, times its density.
+ */
+Color colorize(const Bin &bin, const ColorMap *colorMap);
+void colorize(const Bin *bins, size_t count, const ColorMap *colorMap,
+              Color *output);
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_COLORIZE_H
@@ -0,0 +1,280 @@
+#include "optimize.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <stdx/optional.h>
+#include "ast/ast.h"
+
+namespace chaoskit::core {
+
+using ast::apply_visitor;
+using UnaryFn = ast::UnaryFunction_Type;
+using BinaryFn = ast::BinaryFunction_Type;
+
+namespace {
+
+float evaluate(UnaryFn type, float a) {
+  switch (type) {
+    case UnaryFn::SIN:
+      return sinf(a);
+    case UnaryFn::COS:
+      return cosf(a);
+    case UnaryFn::TAN:
+      return tanf(a);
+    case UnaryFn::MINUS:
+      return -a;
+    case UnaryFn::SQRT:
+      return sqrtf(a);
+    case UnaryFn::ATAN:
+      return atanf(a);
+    case UnaryFn::TRUNC:
+      return truncf(a);
+    case UnaryFn::EXP:
+      return expf(a);
+    case UnaryFn::FLOOR:
+      return floorf(a);
+    case UnaryFn::CEIL:
+      return ceilf(a);
+    case UnaryFn::SIGNUM:
+      return std::signbit(a) ? -1.f : 1.f;
+    case UnaryFn::ABS:
+      return fabsf(a);
+    case UnaryFn::NOT:
+      return !a;
+    case UnaryFn::FRAC: {
+      float unused;
+      return modff(a, &unused);
+    }
+  }
+  throw std::invalid_argument(std::string("Unknown unary function: ") +
+                              type._to_string());
+}
+
+float evaluate(BinaryFn type, float a, float b) {
+  switch (type) {
+    case BinaryFn::ADD:
+      return a + b;
+    case BinaryFn::SUBTRACT:
+      return a - b;
+    case BinaryFn::MULTIPLY:
+      return a * b;
+    case BinaryFn::DIVIDE:
+      return a / b;
+    case BinaryFn::POWER:
+      return powf(a, b);
+    case BinaryFn::MODULO:
+      return fmodf(a, b);
+    case BinaryFn::AND:
+      return a && b;
+    case BinaryFn::OR:
+      return a || b;
+    case BinaryFn::LESS_THAN:
+      return a < b;
+    case BinaryFn::GREATER_THAN:
+      return a > b;
+    case BinaryFn::EQUALS:
+      return a == b;
+    case BinaryFn::LESS_THAN_OR_EQUAL:
+      return a <= b;
+    case BinaryFn::GREATER_THAN_OR_EQUAL:
+      return a >= b;
+    case BinaryFn::DISTANCE:
+      return fabsf(a - b);
+  }
+  throw std::invalid_argument(std::string("Unknown binary function: ") +
+                              type._to_string());
+}
+
+/** Returns the value of a literal, or nothing for any other expression. */
+struct Literal {
+  stdx::optional<float> operator()(float number) const { return number; }
+
+  template <typename T>
+  stdx::optional<float> operator()(const T &) const {
+    return stdx::nullopt;
+  }
+};
+
+/** Returns the argument of -x, or nothing for any other expression. */
+struct NegatedArgument {
+  stdx::optional<ast::Expression> operator()(
+      const ast::UnaryFunction &function) const {
+    if (function.type() == +UnaryFn::MINUS) {
+      return function.argument();
+    }
+    return stdx::nullopt;
+  }
+
+  template <typename T>
+  stdx::optional<ast::Expression> operator()(const T &) const {
+    return stdx::nullopt;
+  }
+};
+
+struct ContainsParameter {
+  bool operator()(const ast::Parameter &) const { return true; }
+  bool operator()(const ast::UnaryFunction &function) const {
+    return apply_visitor(*this, function.argument());
+  }
+  bool operator()(const ast::BinaryFunction &function) const {
+    return apply_visitor(*this, function.first()) ||
+           apply_visitor(*this, function.second());
+  }
+
+  template <typename T>
+  bool operator()(const T &) const {
+    return false;
+  }
+};
+
+bool isLiteral(const ast::Expression &expression, float value) {
+  auto literal = apply_visitor(Literal(), expression);
+  return literal && *literal == value;
+}
+
+bool containsParameter(const ast::WeightedFormula &formula) {
+  return apply_visitor(ContainsParameter(), formula.formula().x()) ||
+         apply_visitor(ContainsParameter(), formula.formula().y());
+}
+
+class Optimizer {
+ public:
+  explicit Optimizer(const Params *params) : params_(params) {}
+
+  ast::Expression operator()(float number) const { return number; }
+  ast::Expression operator()(const ast::Input &input) const { return input; }
+  ast::Expression operator()(const ast::Output &output) const {
+    return output;
+  }
+
+  ast::Expression operator()(const ast::Parameter &parameter) const {
+    if (params_) {
+      try {
+        return params_->at(index_).at(parameter.index());
+      } catch (std::out_of_range &e) {
+        // Left for the interpreter to report.
+      }
+    }
+    return parameter;
+  }
+
+  ast::Expression operator()(const ast::UnaryFunction &function) const {
+    ast::Expression argument = apply_visitor(*this, function.argument());
+
+    if (auto value = apply_visitor(Literal(), argument)) {
+      return evaluate(function.type(), *value);
+    }
+    if (function.type() == +UnaryFn::MINUS) {
+      if (auto negated = apply_visitor(NegatedArgument(), argument)) {
+        return *negated;
+      }
+    }
+    return ast::UnaryFunction(function.type(), argument);
+  }
+
+  ast::Expression operator()(const ast::BinaryFunction &function) const {
+    ast::Expression first = apply_visitor(*this, function.first());
+    ast::Expression second = apply_visitor(*this, function.second());
+
+    auto firstValue = apply_visitor(Literal(), first);
+    auto secondValue = apply_visitor(Literal(), second);
+    if (firstValue && secondValue) {
+      return evaluate(function.type(), *firstValue, *secondValue);
+    }
+
+    switch (function.type()) {
+      case BinaryFn::ADD:
+        if (isLiteral(first, 0.f)) return second;
+        if (isLiteral(second, 0.f)) return first;
+        break;
+      case BinaryFn::SUBTRACT:
+        if (isLiteral(second, 0.f)) return first;
+        break;
+      case BinaryFn::MULTIPLY:
+        if (isLiteral(first, 1.f)) return second;
+        if (isLiteral(second, 1.f)) return first;
+        break;
+      case BinaryFn::DIVIDE:
+        if (isLiteral(second, 1.f)) return first;
+        break;
+      default:
+        break;
+    }
+    return ast::BinaryFunction(function.type(), first, second);
+  }
+
+  ast::System operator()(const ast::System &system) {
+    std::vector<ast::LimitedBlend> blends;
+    for (size_t i = 0; i < system.blends().size(); i++) {
+      const auto &blend = system.blends()[i];
+      blends.emplace_back((*this)(blend.blend(), i), blend.limit());
+    }
+    return ast::System(std::move(blends),
+                       (*this)(system.final_blend(), SystemIndex::FINAL_BLEND));
+  }
+
+ private:
+  const Params *params_;
+  SystemIndex index_;
+
+  ast::Blend operator()(const ast::Blend &blend, size_t blendIndex) {
+    std::vector<ast::WeightedFormula> formulas;
+    index_ = SystemIndex{blendIndex, 0};
+    for (const auto &formula : blend.formulas()) {
+      formulas.emplace_back(
+          ast::Formula(apply_visitor(*this, formula.formula().x()),
+                       apply_visitor(*this, formula.formula().y())),
+          formula.weight_x(), formula.weight_y());
+      index_.formula++;
+    }
+    dropZeroWeightFormulas(formulas);
+
+    index_.formula = SystemIndex::COLORING_METHOD;
+    return ast::Blend(std::move(formulas), blend.pre(), blend.post(),
+                      apply_visitor(*this, blend.coloringMethod()));
+  }
+
+  static void dropZeroWeightFormulas(
+      std::vector<ast::WeightedFormula> &formulas) {
+    if (formulas.empty()) {
+      return;
+    }
+
+    // Parameters are looked up by the position of their formula, so nothing
+    // before a formula that still reads parameters can be removed.
+    std::vector<ast::WeightedFormula> kept;
+    bool canDrop = true;
+    for (auto it = formulas.rbegin(); it != formulas.rend(); ++it) {
+      bool isZero = it->weight_x() == 0.f && it->weight_y() == 0.f;
+      if (!(isZero && canDrop)) {
+        kept.insert(kept.begin(), *it);
+      }
+      if (containsParameter(*it)) {
+        canDrop = false;
+      }
+    }
+
+    // A blend without formulas passes its input through, so keep a formula
+    // that sums to zero instead.
+    if (kept.empty()) {
+      kept.emplace_back(ast::Formula(0.f, 0.f));
+    }
+    formulas = std::move(kept);
+  }
+};
+
+}  // namespace
+
+ast::System optimize(const ast::System &system) {
+  return Optimizer(nullptr)(system);
+}
+
+ast::System optimize(const ast::System &system, const Params &params) {
+  return Optimizer(&params)(system);
+}
+
+ast::Expression optimize(const ast::Expression &expression) {
+  return apply_visitor(Optimizer(nullptr), expression);
+}
+
+}  // namespace chaoskit::core
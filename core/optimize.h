@@ -0,0 +1,30 @@
+#ifndef CHAOSKIT_CORE_OPTIMIZE_H
+#define CHAOSKIT_CORE_OPTIMIZE_H
+
+#include <ast/Expression.h>
+#include <ast/System.h>
+#include "Params.h"
+
+namespace chaoskit::core {
+
+/**
+ * Returns a cheaper system that computes the same values: constants are
+ * folded, x * 1, x + 0, x - 0, x / 1 and -(-x) are simplified, and formulas
+ * with zero weights are dropped.
+ *
+ * The rewrites assume finite values, e.g. the sign of a zero or a NaN that
+ * would come out of 0 * infinity are not preserved.
+ */
+ast::System optimize(const ast::System &system);
+
+/**
+ * Same as above, but also replaces every parameter found in `params` by its
+ * value. Parameters that are missing are left in place.
+ */
+ast::System optimize(const ast::System &system, const Params &params);
+
+ast::Expression optimize(const ast::Expression &expression);
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_OPTIMIZE_H
@@ -0,0 +1,64 @@
+#ifndef CHAOSKIT_CORE_UNIFORM_H
+#define CHAOSKIT_CORE_UNIFORM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace chaoskit::core {
+
+/** Maps 32 random bits to a float in [0; 1). */
+inline float unitFloat(uint32_t bits) {
+  // The upper 24 bits fill the whole mantissa.
+  return static_cast<float>(bits >> 8) * (1.f / 16777216.f);
+}
+
+/**
+ * Returns a number in [min; max] from a generator of 32-bit words, using
+ * Lemire's nearly divisionless method with rejection, so without any bias.
+ */
+template <typename Generator>
+int uniformInt(Generator &generator, int min, int max) {
+  auto range = static_cast<uint32_t>(static_cast<int64_t>(max) - min) + 1;
+  if (range == 0) {
+    return static_cast<int>(generator());
+  }
+
+  uint64_t product = static_cast<uint64_t>(generator()) * range;
+  auto low = static_cast<uint32_t>(product);
+  if (low < range) {
+    uint32_t threshold = -range % range;
+    while (low < threshold) {
+      product = static_cast<uint64_t>(generator()) * range;
+      low = static_cast<uint32_t>(product);
+    }
+  }
+  return static_cast<int>(static_cast<int64_t>(min) + (product >> 32));
+}
+
+/**
+ * Fills `out` with `count` floats in [min; max). Bits are produced first and
+ * converted in a separate loop, which the compiler can vectorize even though
+ * the generator itself is sequential.
+ */
+template <typename Generator>
+void fillUniform(Generator &generator, float *out, size_t count, float min,
+                 float max) {
+  constexpr size_t CHUNK = 64;
+  uint32_t bits[CHUNK];
+  float scale = max - min;
+
+  for (size_t start = 0; start < count; start += CHUNK) {
+    size_t chunk = std::min(CHUNK, count - start);
+    for (size_t i = 0; i < chunk; i++) {
+      bits[i] = generator();
+    }
+    for (size_t i = 0; i < chunk; i++) {
+      out[start + i] = min + scale * unitFloat(bits[i]);
+    }
+  }
+}
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_UNIFORM_H
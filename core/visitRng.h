@@ -0,0 +1,30 @@
+#ifndef CHAOSKIT_CORE_VISITRNG_H
+#define CHAOSKIT_CORE_VISITRNG_H
+
+#include <utility>
+#include "FastRng.h"
+#include "Philox.h"
+#include "Rng.h"
+
+namespace chaoskit::core {
+
+/**
+ * Calls `action` with `rng` as its concrete type if it's one of the final
+ * generators, so that the calls `action` makes are resolved statically, or as
+ * a plain Rng otherwise. The lookup costs about as much as a virtual call, so
+ * it pays off when `action` draws many numbers.
+ */
+template <typename Action>
+decltype(auto) visitRng(Rng &rng, Action &&action) {
+  if (auto *philox = dynamic_cast<PhiloxRng *>(&rng)) {
+    return std::forward<Action>(action)(*philox);
+  }
+  if (auto *fast = dynamic_cast<FastRng *>(&rng)) {
+    return std::forward<Action>(action)(*fast);
+  }
+  return std::forward<Action>(action)(rng);
+}
+
+}  // namespace chaoskit::core
+
+#endif  // CHAOSKIT_CORE_VISITRNG_H
@@ -1,8 +1,12 @@
 #include <QImage>
 #include <iostream>
+#include <thread>
+#include <vector>
 #include "core/Color.h"
 #include "core/ColorMapRegistry.h"
+#include "core/Scheduler.h"
 #include "core/SimpleHistogramGenerator.h"
+#include "core/colorize.h"
 #include "core/structures/Blend.h"
 #include "core/structures/Formula.h"
 #include "core/structures/System.h"
@@ -13,10 +17,12 @@
 
 using chaoskit::core::Blend;
 using chaoskit::core::Color;
+using chaoskit::core::colorize;
 using chaoskit::core::ColorMapRegistry;
 using chaoskit::core::FinalBlend;
 using chaoskit::core::Formula;
 using chaoskit::core::scale;
+using chaoskit::core::Scheduler;
 using chaoskit::core::SimpleHistogramGenerator;
 using chaoskit::core::System;
 using chaoskit::core::toSource;
@@ -47,14 +53,21 @@ int main(int argc, char **argv) {
 
   ColorMapRegistry colorMaps;
   SimpleHistogramGenerator generator(*system, 512, 512);
-  generator.setColorMap(colorMaps.get("Rainbow"));
   generator.setIterationCount(1000000);
+  generator.setThreadCount(std::thread::hardware_concurrency());
   generator.run();
 
-  const Color *buffer = generator.data();
+  auto bins = generator.bins();
+  std::vector<Color> buffer(bins.size());
+  colorize(bins.data(), bins.size(), colorMaps.get("Rainbow"), buffer.data());
 
   QImage image(512, 512, QImage::Format_RGB32);
-  for (int y = 0; y < 512; y++) {
+  // QImage isn't thread-safe, even scanLine() touches shared state: detach
+  // once here, then each task only writes to its own rows.
+  uchar *bits = image.bits();
+  auto bytesPerLine = static_cast<size_t>(image.bytesPerLine());
+  Scheduler::shared().parallelFor(0, 512, 16, [&](size_t y) {
+    auto *line = reinterpret_cast<QRgb *>(bits + y * bytesPerLine);
     for (int x = 0; x < 512; x++) {
       int index = y * 512 + x;
       const Color &color = buffer[index];
@@ -64,12 +77,12 @@ int main(int argc, char **argv) {
       double scale =
           logScale * std::pow(scaledIntensity, 2.2) / scaledIntensity;
 
-      image.setPixelColor(x, y,
-                          QColor::fromRgbF(CLAMP(color.r * scale, 0.0, 1.0),
-                                           CLAMP(color.g * scale, 0.0, 1.0),
-                                           CLAMP(color.b * scale, 0.0, 1.0)));
+      line[x] = QColor::fromRgbF(CLAMP(color.r * scale, 0.0, 1.0),
+                                 CLAMP(color.g * scale, 0.0, 1.0),
+                                 CLAMP(color.b * scale, 0.0, 1.0))
+                    .rgb();
     }
-  }
+  });
   image.save("lol.png");
 
   return 0;
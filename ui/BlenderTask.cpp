@@ -1,19 +1,23 @@
 #include "BlenderTask.h"
 #include <QDebug>
 #include <QTimer>
+#include <algorithm>
 #include "core/errors.h"
 #include "core/toSource.h"
 
+using chaoskit::core::BytecodeInterpreter;
 using chaoskit::core::MissingParameterError;
 using chaoskit::core::Particle;
 using chaoskit::core::Point;
-using chaoskit::core::SimpleInterpreter;
 using chaoskit::core::toSource;
 
 namespace chaoskit::ui {
 
 namespace {
 
+/** Keeps a slice bounded even if the clock misbehaves. */
+constexpr size_t MAX_SLICE_CHUNKS = 4096;
+
 float distance(const Point &a, const Point &b) {
   float dx = a.x() - b.x();
   float dy = a.y() - b.y();
@@ -23,9 +27,36 @@ float distance(const Point &a, const Point &b) {
 }  // namespace
 
 void BlenderTask::setSystem(const core::System *system) {
-  interpreter_ = std::make_unique<SimpleInterpreter>(
-      toSource(*system), ttl_, core::Params::fromSystem(*system), rng_);
+  try {
+    interpreter_ = std::make_unique<BytecodeInterpreter>(
+        toSource(*system), ttl_, core::Params::fromSystem(*system), rng_);
+  } catch (MissingParameterError &e) {
+    qCritical() << "In BlenderTask::setSystem():" << e.what();
+    interpreter_.reset();
+    stop();
+    return;
+  }
+  interpreter_->setBackend(core::ExecutionBackend::Jit);
   particle_ = interpreter_->randomizeParticle();
+  discardSamples();
+}
+
+void BlenderTask::setParams(const core::System *system) {
+  // A previous system may have been rejected, this one might be complete.
+  if (!interpreter_) {
+    setSystem(system);
+    return;
+  }
+
+  try {
+    interpreter_->setParams(core::Params::fromSystem(*system));
+  } catch (MissingParameterError &e) {
+    qCritical() << "In BlenderTask::setParams():" << e.what();
+    interpreter_.reset();
+    stop();
+    return;
+  }
+  discardSamples();
 }
 
 void BlenderTask::start() {
@@ -52,16 +83,50 @@ void BlenderTask::calculate() {
     return;
   }
 
-  try {
-    auto [next_state, output] = (*interpreter_)(particle_);
-    particle_ = next_state;
-    emit stepCompleted(output.point, output.color);
+  using Clock = std::chrono::steady_clock;
+  uint32_t epoch = epoch_.load(std::memory_order_relaxed);
+  auto start = Clock::now();
 
-    QTimer::singleShot(0, this, &BlenderTask::calculate);
-  } catch (MissingParameterError &e) {
-    qCritical() << "In BlenderTask::calculate():" << e.what();
-    stop();
+  size_t chunks = 0;
+  bool full = false;
+  while (chunks < slice_chunks_ &&
+         epoch_.load(std::memory_order_relaxed) == epoch) {
+    if (!fillRing()) {
+      full = true;
+      break;
+    }
+    chunks++;
+  }
+
+  // Only complete slices tell how long a chunk takes.
+  if (chunks == slice_chunks_) {
+    auto perChunk =
+        std::max((Clock::now() - start) / chunks, Clock::duration(1));
+    slice_chunks_ = std::clamp<size_t>(
+        static_cast<size_t>(TARGET_LATENCY / perChunk), 1, MAX_SLICE_CHUNKS);
+  }
+
+  // When the ring is full, give the gatherer some time to catch up.
+  QTimer::singleShot(full ? 1 : 0, this, &BlenderTask::calculate);
+}
+
+bool BlenderTask::fillRing() {
+  if (pushed_ == samples_.size()) {
+    interpreter_->iterate(particle_, outputs_.data(), outputs_.size());
+    for (size_t i = 0; i < samples_.size(); i++) {
+      const auto &output = outputs_[i];
+      samples_[i] = {output.x(), output.y(), output.color};
+    }
+    pushed_ = 0;
+  }
+
+  size_t pushed =
+      ring_->push(samples_.data() + pushed_, samples_.size() - pushed_);
+  pushed_ += pushed;
+  if (pushed > 0) {
+    emit samplesAvailable();
   }
+  return pushed_ == samples_.size();
 }
 
 void BlenderTask::setTtl(int32_t ttl) {
@@ -69,6 +134,7 @@ void BlenderTask::setTtl(int32_t ttl) {
   if (interpreter_) {
     interpreter_->setTtl(ttl);
     particle_ = interpreter_->randomizeParticle();
+    discardSamples();
   }
 }
 
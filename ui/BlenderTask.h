@@ -1,21 +1,51 @@
 #ifndef CHAOSKIT_UI_BLENDERTASK_H
 #define CHAOSKIT_UI_BLENDERTASK_H
 
-#include <core/SimpleInterpreter.h>
+#include <core/BytecodeInterpreter.h>
 #include <QObject>
+#include <atomic>
+#include <chrono>
+#include <vector>
 #include "Particle.h"
+#include "SampleRing.h"
 
 namespace chaoskit::ui {
 
 class BlenderTask : public QObject {
   Q_OBJECT
  public:
-  explicit BlenderTask(std::shared_ptr<core::Rng> rng,
-                       int32_t ttl = core::Particle::IMMORTAL)
-      : interpreter_(), particle_{}, ttl_(ttl), rng_(std::move(rng)) {}
+  /** Number of samples computed before handing them to the gatherer. */
+  static constexpr size_t CHUNK_SIZE = 4096;
+  /**
+   * How long the task keeps its thread between two visits to the event loop.
+   * The number of chunks per slice is adjusted to match it.
+   */
+  static constexpr std::chrono::milliseconds TARGET_LATENCY{8};
+
+  BlenderTask(std::shared_ptr<core::Rng> rng, std::shared_ptr<SampleRing> ring,
+              int32_t ttl = core::Particle::IMMORTAL)
+      : interpreter_(),
+        particle_{},
+        ttl_(ttl),
+        rng_(std::move(rng)),
+        ring_(std::move(ring)),
+        outputs_(CHUNK_SIZE),
+        samples_(CHUNK_SIZE),
+        pushed_(CHUNK_SIZE) {}
+
+  /**
+   * Makes the current slice return to the event loop as soon as possible, so
+   * that queued calls run. Can be called from any thread.
+   */
+  void interrupt() { epoch_.fetch_add(1, std::memory_order_relaxed); }
 
  public slots:
   void setSystem(const chaoskit::core::System *system);
+  /**
+   * Updates parameter values in place, keeping the particle. The system must
+   * have the same structure as the one last set.
+   */
+  void setParams(const chaoskit::core::System *system);
   void start();
   void stop();
   void setTtl(int32_t ttl);
@@ -23,17 +53,32 @@ class BlenderTask : public QObject {
  signals:
   void started();
   void stopped();
-  void stepCompleted(const chaoskit::core::Point &point, float color);
+  /** New samples were pushed to the ring. */
+  void samplesAvailable();
 
  private slots:
   void calculate();
 
  private:
-  std::unique_ptr<core::SimpleInterpreter> interpreter_;
+  std::unique_ptr<core::BytecodeInterpreter> interpreter_;
   core::Particle particle_;
   int32_t ttl_;
   bool running_ = false;
+  std::atomic<uint32_t> epoch_{0};
+  size_t slice_chunks_ = 1;
   std::shared_ptr<core::Rng> rng_;
+  std::shared_ptr<SampleRing> ring_;
+  std::vector<core::Particle> outputs_;
+  std::vector<Sample> samples_;
+  /** Number of samples_ already pushed to ring_. */
+  size_t pushed_;
+
+  void discardSamples() { pushed_ = samples_.size(); }
+  /**
+   * Pushes the current chunk, computing it first if needed. Returns false
+   * when the ring is full.
+   */
+  bool fillRing();
 };
 
 }  // namespace chaoskit::ui
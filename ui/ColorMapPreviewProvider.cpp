@@ -1,19 +1,40 @@
 #include "ColorMapPreviewProvider.h"
 #include <QDebug>
+#include <exception>
 #include "ColorMap.h"
 
 namespace chaoskit::ui {
 
 namespace {
 
-class ColorMapResponse : public QQuickImageResponse, public QRunnable {
+class ColorMapResponse : public QQuickImageResponse {
  public:
   ColorMapResponse(const core::ColorMap* colorMap, const QSize& requestedSize)
-      : colorMap_(colorMap), requestedSize_(requestedSize) {
-    setAutoDelete(false);
+      : colorMap_(colorMap), requestedSize_(requestedSize) {}
+
+  /** Renders the image, then reports it done even if rendering failed. */
+  void run() {
+    try {
+      render();
+    } catch (const std::exception& e) {
+      error_ = QString::fromUtf8(e.what());
+    }
+    emit finished();
+  }
+
+  [[nodiscard]] QQuickTextureFactory* textureFactory() const override {
+    return QQuickTextureFactory::textureFactoryForImage(image_);
   }
 
-  void run() override {
+  [[nodiscard]] QString errorString() const override { return error_; }
+
+ private:
+  const core::ColorMap* colorMap_;
+  QSize requestedSize_;
+  QImage image_;
+  QString error_;
+
+  void render() {
     if (requestedSize_.isValid()) {
       image_ = QImage(requestedSize_, QImage::Format_RGB32);
     } else {
@@ -29,18 +50,7 @@ class ColorMapResponse : public QQuickImageResponse, public QRunnable {
         image_.setPixelColor(x, y, qColor);
       }
     }
-
-    emit finished();
-  }
-
-  [[nodiscard]] QQuickTextureFactory* textureFactory() const override {
-    return QQuickTextureFactory::textureFactoryForImage(image_);
   }
-
- private:
-  const core::ColorMap* colorMap_;
-  QSize requestedSize_;
-  QImage image_;
 };
 
 }  // namespace
@@ -49,7 +59,7 @@ QQuickImageResponse* ColorMapPreviewProvider::requestImageResponse(
     const QString& id, const QSize& requestedSize) {
   auto* response =
       new ColorMapResponse(colorMapRegistry_->get(id), requestedSize);
-  pool_.start(response);
+  tasks_.run([response] { response->run(); });
   return response;
 }
 
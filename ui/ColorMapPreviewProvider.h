@@ -2,8 +2,8 @@
 #define CHAOSKIT_UI_COLORMAPPREVIEWPROVIDER_H
 
 #include <QQuickAsyncImageProvider>
-#include <QThreadPool>
 #include "ColorMapRegistry.h"
+#include "core/Scheduler.h"
 
 namespace chaoskit::ui {
 
@@ -17,7 +17,12 @@ class ColorMapPreviewProvider : public QQuickAsyncImageProvider {
 
  private:
   const ColorMapRegistry* colorMapRegistry_;
-  QThreadPool pool_;
+  /**
+   * Responses being rendered. Destroying the group waits for them, so none
+   * outlives the provider or what it points to.
+   */
+  core::TaskGroup tasks_{core::Scheduler::shared(),
+                         core::TaskPriority::Interactive};
 };
 
 }  // namespace chaoskit::ui
@@ -4,6 +4,7 @@
 #include <QLoggingCategory>
 #include <QRandomGenerator>
 #include <QtGui/QTransform>
+#include <algorithm>
 #include "core/toSource.h"
 #include "library/util.h"
 #include "state/Id.h"
@@ -102,6 +103,10 @@ DocumentModel::DocumentModel(QObject* parent)
           &DocumentModel::structureChanged);
   connect(this, &QAbstractItemModel::modelReset, this,
           &DocumentModel::systemReset);
+  connect(this, &DocumentModel::structureChanged, this,
+          &DocumentModel::debugSourceChanged);
+  connect(this, &DocumentModel::paramsChanged, this,
+          &DocumentModel::debugSourceChanged);
 }
 
 ///////////////////////////////////////////////////////////////////// Custom API
@@ -941,7 +946,17 @@ QModelIndex DocumentModel::getFormulaIndex(const QModelIndex& blendOrFormula) {
 void DocumentModel::handleDataChanges(const QModelIndex& topLeft,
                                       const QModelIndex& bottomRight,
                                       const QVector<int>& roles) {
-  if (topLeft != documentIndex() && !roles.contains(Qt::DisplayRole)) {
+  if (topLeft == documentIndex() || roles.contains(Qt::DisplayRole)) {
+    return;
+  }
+
+  bool onlyParams =
+      !roles.isEmpty() && std::all_of(roles.begin(), roles.end(), [](int role) {
+        return role == ParamsRole || role == ColoringMethodParamsRole;
+      });
+  if (onlyParams) {
+    emit paramsChanged();
+  } else {
     emit structureChanged();
   }
 }
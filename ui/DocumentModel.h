@@ -31,7 +31,7 @@ class DocumentEntryType {
 
 class DocumentModel : public QAbstractItemModel {
   Q_OBJECT
-  Q_PROPERTY(QString debugSource READ debugSource NOTIFY structureChanged)
+  Q_PROPERTY(QString debugSource READ debugSource NOTIFY debugSourceChanged)
   Q_PROPERTY(QModelIndex documentIndex READ documentIndex NOTIFY systemReset)
   Q_PROPERTY(QModelIndex systemIndex READ systemIndex NOTIFY systemReset)
   Q_PROPERTY(
@@ -135,6 +135,12 @@ class DocumentModel : public QAbstractItemModel {
 
  signals:
   void structureChanged();
+  /**
+   * Only parameter values changed, so the system keeps its structure and
+   * can be updated in place.
+   */
+  void paramsChanged();
+  void debugSourceChanged();
   void systemReset();
   void documentReset();
 
@@ -3,8 +3,8 @@
 #include <QImage>
 #include <QPainter>
 #include <QQuickImageResponse>
-#include <QRunnable>
 #include <QSize>
+#include <exception>
 #include <memory>
 #include <vector>
 #include "core/Params.h"
@@ -95,14 +95,34 @@ QRectF getBoundsForGrid(const QVector<QPointF>& grid) {
   return QRectF(left, top, right - left, bottom - top);
 }
 
-class FormulaPreviewResponse : public QQuickImageResponse, public QRunnable {
+class FormulaPreviewResponse : public QQuickImageResponse {
  public:
   FormulaPreviewResponse(QString type, const QSize& requestedSize)
-      : type_(std::move(type)), requestedSize_(requestedSize) {
-    setAutoDelete(false);
+      : type_(std::move(type)), requestedSize_(requestedSize) {}
+
+  /** Renders the image, then reports it done even if rendering failed. */
+  void run() {
+    try {
+      render();
+    } catch (const std::exception& e) {
+      error_ = QString::fromUtf8(e.what());
+    }
+    emit finished();
+  }
+
+  [[nodiscard]] QQuickTextureFactory* textureFactory() const override {
+    return QQuickTextureFactory::textureFactoryForImage(image_);
   }
 
-  void run() override {
+  [[nodiscard]] QString errorString() const override { return error_; }
+
+ private:
+  QString type_;
+  QImage image_;
+  QSize requestedSize_;
+  QString error_;
+
+  void render() {
     QSize imageSize(200, 200);
 
     image_ = QImage(imageSize, QImage::Format_RGBA64);
@@ -149,18 +169,7 @@ class FormulaPreviewResponse : public QQuickImageResponse, public QRunnable {
     if (requestedSize_.isValid()) {
       image_ = image_.scaled(requestedSize_);
     }
-
-    emit finished();
-  }
-
-  [[nodiscard]] QQuickTextureFactory* textureFactory() const override {
-    return QQuickTextureFactory::textureFactoryForImage(image_);
   }
-
- private:
-  QString type_;
-  QImage image_;
-  QSize requestedSize_;
 };
 
 }  // namespace
@@ -168,7 +177,7 @@ class FormulaPreviewResponse : public QQuickImageResponse, public QRunnable {
 QQuickImageResponse* FormulaPreviewProvider::requestImageResponse(
     const QString& id, const QSize& requestedSize) {
   auto* response = new FormulaPreviewResponse(id, requestedSize);
-  pool_.start(response);
+  tasks_.run([response] { response->run(); });
   return response;
 }
 
@@ -2,7 +2,7 @@
 #define CHAOSKIT_UI_FORMULAPREVIEWPROVIDER_H
 
 #include <QQuickAsyncImageProvider>
-#include <QThreadPool>
+#include "core/Scheduler.h"
 
 namespace chaoskit::ui {
 
@@ -12,7 +12,12 @@ class FormulaPreviewProvider : public QQuickAsyncImageProvider {
       const QString& id, const QSize& requestedSize) override;
 
  private:
-  QThreadPool pool_;
+  /**
+   * Responses being rendered. Destroying the group waits for them, so none
+   * outlives the provider or what it points to.
+   */
+  core::TaskGroup tasks_{core::Scheduler::shared(),
+                         core::TaskPriority::Interactive};
 };
 
 }  // namespace chaoskit::ui
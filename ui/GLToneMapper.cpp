@@ -1,9 +1,19 @@
 #include "GLToneMapper.h"
+#include <vector>
 
 namespace chaoskit::ui {
 
 namespace {
 
+using core::HistogramBuffer;
+
+/** Uploaded in place of stale tiles, its rows are TILE_SIZE bins apart. */
+const std::vector<core::Bin> &zeroTile() {
+  static const std::vector<core::Bin> tile(HistogramBuffer::TILE_SIZE *
+                                           HistogramBuffer::TILE_SIZE);
+  return tile;
+}
+
 const char *VERTEX_SHADER = R"XD(
 #version 150
 
@@ -24,6 +34,7 @@ const char *FRAGMENT_SHADER = R"XD(
 in vec2 uv;
 out vec4 outColor;
 uniform sampler2D histogram;
+uniform sampler1D colorMap;
 uniform float gamma;
 uniform float exposure;
 uniform float vibrancy;
@@ -37,7 +48,14 @@ float logmap(float x) {
 
 void main()
 {
-    vec4 point = texture(histogram, uv);
+    // Interpolated bins still hold density and color sum, so the average
+    // color of a blend of bins is weighted by their densities.
+    vec2 bin = texture(histogram, uv).xy;
+    float density = bin.x;
+    float size = float(textureSize(colorMap, 0));
+    float color = clamp(bin.y / density, 0.0, 1.0);
+    vec3 mapped = texture(colorMap, (color * (size - 1.0) + 0.5) / size).rgb;
+    vec4 point = vec4(mapped * density, density);
     float intensity = point.w * pow(E, -exposure + 1.0);
 
     float scale = logmap(intensity) / intensity;
@@ -54,6 +72,9 @@ void main()
 }
 )XD";
 
+static_assert(sizeof(core::Bin) == 2 * sizeof(float),
+              "Bins are uploaded as two-channel textures");
+
 }  // namespace
 
 void GLToneMapper::getUniformLocation(const char *name, GLuint *output) {
@@ -79,6 +100,8 @@ void GLToneMapper::initializeGL() {
 
   // Setup textures
   glGenTextures(1, &histogramTexture_);
+  glGenTextures(1, &colorMapTexture_);
+  loadColorMap();
 
   // Setup shaders
   program_ = new QOpenGLShaderProgram(this);
@@ -89,6 +112,8 @@ void GLToneMapper::initializeGL() {
   getUniformLocation("gamma", &gammaLocation_);
   getUniformLocation("exposure", &exposureLocation_);
   getUniformLocation("vibrancy", &vibrancyLocation_);
+  getUniformLocation("histogram", &histogramLocation_);
+  getUniformLocation("colorMap", &colorMapLocation_);
   auto positionAttribute =
       static_cast<GLuint>(program_->attributeLocation("position"));
 
@@ -104,14 +129,66 @@ void GLToneMapper::setExposure(float exposure) { exposure_ = exposure; }
 
 void GLToneMapper::setVibrancy(float vibrancy) { vibrancy_ = vibrancy; }
 
+void GLToneMapper::setColorMap(const core::ColorMap *colorMap) {
+  if (colorMap == colorMap_) {
+    return;
+  }
+
+  colorMap_ = colorMap;
+  loadColorMap();
+}
+
+void GLToneMapper::loadColorMap() {
+  std::vector<core::Color> entries(COLOR_MAP_SIZE, core::Color(1.f));
+  if (colorMap_) {
+    std::vector<float> colors(COLOR_MAP_SIZE);
+    for (int i = 0; i < COLOR_MAP_SIZE; i++) {
+      colors[i] = static_cast<float>(i) / (COLOR_MAP_SIZE - 1);
+    }
+    colorMap_->mapMany(colors.data(), colors.size(), entries.data());
+  }
+
+  glBindTexture(GL_TEXTURE_1D, colorMapTexture_);
+  glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA32F, COLOR_MAP_SIZE, 0, GL_RGBA,
+               GL_FLOAT, entries.data());
+}
+
 void GLToneMapper::syncBuffer(const core::HistogramBuffer &buffer) {
   glBindTexture(GL_TEXTURE_2D, histogramTexture_);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, buffer.width(), buffer.height(), 0,
-               GL_RGBA, GL_FLOAT, buffer.data());
+
+  if (buffer.width() != textureWidth_ || buffer.height() != textureHeight_ ||
+      buffer.version() < textureVersion_) {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, buffer.width(), buffer.height(),
+                 0, GL_RG, GL_FLOAT, nullptr);
+    textureWidth_ = buffer.width();
+    textureHeight_ = buffer.height();
+    // Every tile changed after version 0.
+    textureVersion_ = 0;
+  }
+
+  // Only upload the tiles that changed since the last sync. Rows of a tile
+  // are contiguous in any layout, so each one takes a single call. Stale
+  // tiles hold leftovers from before a clear and are uploaded as zero.
+  buffer.forEachChangedTile(
+      textureVersion_, [&](const HistogramBuffer::Region &tile) {
+        bool stale = buffer.isStale(tile);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH,
+                      static_cast<GLint>(stale ? HistogramBuffer::TILE_SIZE
+                                               : buffer.rowPitch()));
+        glTexSubImage2D(GL_TEXTURE_2D, 0, tile.x, tile.y, tile.width,
+                        tile.height, GL_RG, GL_FLOAT,
+                        stale ? zeroTile().data()
+                              : buffer.pixel(tile.x, tile.y));
+      });
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  textureVersion_ = buffer.version();
 }
 
 void GLToneMapper::map() {
@@ -122,8 +199,13 @@ void GLToneMapper::map() {
   program_->setUniformValue(gammaLocation_, gamma_);
   program_->setUniformValue(exposureLocation_, exposure_);
   program_->setUniformValue(vibrancyLocation_, vibrancy_);
+  program_->setUniformValue(histogramLocation_, 0);
+  program_->setUniformValue(colorMapLocation_, 1);
   glBindVertexArray(rectArray_);
   glBindBuffer(GL_ARRAY_BUFFER, rectBuffer_);
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_1D, colorMapTexture_);
+  glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_2D, histogramTexture_);
   glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
   program_->release();
@@ -1,6 +1,7 @@
 #ifndef CHAOSKIT_UI_GLTONEMAPPER_H
 #define CHAOSKIT_UI_GLTONEMAPPER_H
 
+#include <core/ColorMap.h>
 #include <core/HistogramBuffer.h>
 #include <QOpenGLFunctions_3_2_Core>
 #include <QOpenGLShaderProgram>
@@ -10,12 +11,17 @@ namespace chaoskit::ui {
 class GLToneMapper : public QObject, protected QOpenGLFunctions_3_2_Core {
   Q_OBJECT
  public:
+  /** Number of entries the color map is sampled into. */
+  static constexpr int COLOR_MAP_SIZE = 1024;
+
   explicit GLToneMapper(QObject *parent = nullptr) : QObject(parent) {}
 
   void initializeGL();
   void setGamma(float gamma);
   void setExposure(float exposure);
   void setVibrancy(float vibrancy);
+  /** Colors the histogram with `colorMap`, or white if null. */
+  void setColorMap(const core::ColorMap *colorMap);
   void syncBuffer(const core::HistogramBuffer &buffer);
   void map();
 
@@ -24,14 +30,22 @@ class GLToneMapper : public QObject, protected QOpenGLFunctions_3_2_Core {
   GLuint rectBuffer_ = 0;
   GLuint rectArray_ = 0;
   GLuint histogramTexture_ = 0;
+  GLuint colorMapTexture_ = 0;
+  const core::ColorMap *colorMap_ = nullptr;
+  size_t textureWidth_ = 0;
+  size_t textureHeight_ = 0;
+  uint64_t textureVersion_ = 0;
   GLuint gammaLocation_ = 0;
   GLuint exposureLocation_ = 0;
   GLuint vibrancyLocation_ = 0;
+  GLuint histogramLocation_ = 0;
+  GLuint colorMapLocation_ = 0;
   float gamma_ = 2.2f;
   float exposure_ = 0.f;
   float vibrancy_ = 0.f;
 
   void getUniformLocation(const char *name, GLuint *output);
+  void loadColorMap();
 };
 
 }  // namespace chaoskit::ui
@@ -3,47 +3,148 @@
 
 namespace chaoskit::ui {
 
-using core::Color;
-using core::HistogramBuffer;
-using core::Point;
-
-void GathererTask::addPoint(const Point &point, float color) {
-  // Calculate coordinates from the unit rect to the buffer coordinates
-  //  int x = static_cast<int>((point.x() + 1.f) * .5f * buffer_.width());
-  //  int y = static_cast<int>((point.y() + 1.f) * .5f * buffer_.height());
-  auto p = imageSpaceTransform_.map(QPointF(point.x(), point.y()));
-  int x = static_cast<int>(p.x());
-  int y = static_cast<int>(p.y());
-
-  // Add the color if it fits inside
-  if (x >= 0 && y >= 0 && x < buffer_.width() && y < buffer_.height()) {
-    auto *entry = buffer_(static_cast<size_t>(x), static_cast<size_t>(y));
-    Color mappedColor{1, 1, 1, color};
-    if (colorMap_) {
-      mappedColor = colorMap_->map(color);
-    }
+using core::Bin;
+
+void GathererTask::drain() {
+  size_t count;
+  while ((count = ring_->pop(samples_.data(), samples_.size())) > 0) {
+    addSamples(samples_.data(), count);
+    gatheredSamples_ += count;
+    empty_ = false;
+  }
+  flushBinner();
+  writer_.flush();
+  // Publishing catches up a whole snapshot, so wait for the renderer to take
+  // the previous one, unless it's getting old.
+  if (!histogram_.snapshotPending() ||
+      publishTimer_.elapsed() >= PUBLISH_INTERVAL_MS) {
+    publish();
+  }
+}
+
+void GathererTask::flush() {
+  drain();
+  publish();
+  emit flushed();
+}
 
-    mutex_.lock();
-    *entry += mappedColor;
-    mutex_.unlock();
+void GathererTask::publish() {
+  histogram_.publish();
+  publishedSamples_.store(gatheredSamples_, std::memory_order_relaxed);
+  publishTimer_.restart();
+}
+
+void GathererTask::addSamples(const Sample *samples, size_t count) {
+  // The transform only scales and translates.
+  auto scaleX = static_cast<float>(imageSpaceTransform_.m11());
+  auto scaleY = static_cast<float>(imageSpaceTransform_.m22());
+  auto dx = static_cast<float>(imageSpaceTransform_.dx());
+  auto dy = static_cast<float>(imageSpaceTransform_.dy());
+  auto width = static_cast<float>(writer_.width());
+  auto height = static_cast<float>(writer_.height());
+
+  for (size_t i = 0; i < count; i++) {
+    const Sample &sample = samples[i];
+    float x = sample.x * scaleX + dx;
+    float y = sample.y * scaleY + dy;
+
+    // Add the sample if it fits inside, the color map is applied when
+    // tone mapping.
+    if (x >= 0.f && y >= 0.f && x < width && y < height) {
+      auto column = static_cast<uint32_t>(x);
+      auto row = static_cast<uint32_t>(y);
+      if (binning_) {
+        binner_.add(column, row, sample.color);
+        if (binner_.full()) {
+          flushBinner();
+        }
+      } else {
+        writer_.add(column, row,
+                    Bin{sampleWeight_, sample.color * sampleWeight_});
+      }
+    }
   }
 }
 
+void GathererTask::flushBinner() {
+  binner_.flush([this](uint32_t x, uint32_t y, float color) {
+    writer_.add(x, y, Bin{sampleWeight_, color * sampleWeight_});
+  });
+}
+
+void GathererTask::setBinning(bool binning) {
+  flushBinner();
+  binning_ = binning;
+}
+
 void GathererTask::setSize(const QSize &size) {
-  QMutexLocker locker(&mutex_);
-  buffer_.resize(static_cast<size_t>(size.width()),
-                 static_cast<size_t>(size.height()));
-  updateImageSpaceTransform(size);
+  size_ = size;
+  updateResolution();
 }
 
-void GathererTask::setColorMap(const chaoskit::core::ColorMap *colorMap) {
-  QMutexLocker locker(&mutex_);
-  colorMap_ = colorMap;
-  buffer_.clear();
+void GathererTask::setInteractive(bool interactive) {
+  if (interactive == interactive_) {
+    return;
+  }
+
+  interactive_ = interactive;
+  updateResolution();
+}
+
+void GathererTask::updateResolution() {
+  // Queued samples were placed for the old size, like those the writer
+  // holds, which the histogram drops.
+  binner_.clear();
+
+  int divisor = interactive_ ? INTERACTIVE_DIVISOR : 1;
+  QSize resolution((size_.width() + divisor - 1) / divisor,
+                   (size_.height() + divisor - 1) / divisor);
+  float sampleWeight = 1.f / static_cast<float>(divisor * divisor);
+  QTransform previousTransform = imageSpaceTransform_;
+  updateImageSpaceTransform(resolution);
+
+  auto width = static_cast<size_t>(resolution.width());
+  auto height = static_cast<size_t>(resolution.height());
+  // An empty histogram has nothing worth a pass over every pixel.
+  if (resolution_.isEmpty() || empty_) {
+    histogram_.resize(width, height);
+  } else {
+    // Both transforms only scale and translate. Pixel values are sample
+    // counts times the sample weight, so the gain keeps the counts.
+    core::HistogramBuffer::Resampling resampling;
+    resampling.ratioX = static_cast<float>(previousTransform.m11() /
+                                           imageSpaceTransform_.m11());
+    resampling.ratioY = static_cast<float>(previousTransform.m22() /
+                                           imageSpaceTransform_.m22());
+    resampling.offsetX =
+        static_cast<float>(previousTransform.dx()) -
+        static_cast<float>(imageSpaceTransform_.dx()) * resampling.ratioX;
+    resampling.offsetY =
+        static_cast<float>(previousTransform.dy()) -
+        static_cast<float>(imageSpaceTransform_.dy()) * resampling.ratioY;
+    resampling.gain = sampleWeight / sampleWeight_;
+    histogram_.resize(width, height, resampling);
+  }
+  resolution_ = resolution;
+  sampleWeight_ = sampleWeight;
+
+  // Picks up the new size right away, before any more samples come in.
+  writer_.flush();
+  binner_.resize(writer_.width(), writer_.height());
+  publish();
 }
+
 void GathererTask::clear() {
-  QMutexLocker locker(&mutex_);
-  buffer_.clear();
+  binner_.clear();
+  histogram_.clear();
+  empty_ = true;
+  writer_.flush();
+  publish();
+}
+
+void GathererTask::decay(float factor) {
+  histogram_.decay(factor);
+  publish();
 }
 
 void GathererTask::updateImageSpaceTransform(const QSizeF &size) {
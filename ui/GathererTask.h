@@ -1,15 +1,19 @@
 #ifndef CHAOSKIT_UI_GATHERERTASK_H
 #define CHAOSKIT_UI_GATHERERTASK_H
 
-#include <QMutex>
-#include <QMutexLocker>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QSize>
 #include <QTransform>
 #include <QVector>
-#include "ColorMap.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "ConcurrentHistogram.h"
 #include "HistogramBuffer.h"
 #include "Point.h"
+#include "SampleRing.h"
+#include "TileBinner.h"
 
 namespace chaoskit::ui {
 
@@ -17,24 +21,94 @@ class GathererTask : public QObject {
   Q_OBJECT
 
  public:
+  /** Maximum number of samples taken from the ring at once. */
+  static constexpr size_t DRAIN_SIZE = 4096;
+  /**
+   * Longest time a snapshot waits for the renderer before newer samples are
+   * published over it.
+   */
+  static constexpr qint64 PUBLISH_INTERVAL_MS = 8;
+  /** Interactive mode divides the resolution by this much on each axis. */
+  static constexpr int INTERACTIVE_DIVISOR = 4;
+
+  explicit GathererTask(std::shared_ptr<SampleRing> ring)
+      : writer_(histogram_.addWriter()),
+        ring_(std::move(ring)),
+        samples_(DRAIN_SIZE) {
+    publishTimer_.start();
+  }
+
+  /**
+   * Calls `action` with the latest snapshot of the histogram. Safe to call
+   * from any thread; the gatherer never waits for it.
+   */
   template <typename Action>
   void withHistogram(Action action) {
-    QMutexLocker locker(&mutex_);
-    action(buffer_);
+    histogram_.withSnapshot(action);
+  }
+
+  /** Version of the latest snapshot. Safe to call from any thread. */
+  [[nodiscard]] uint64_t histogramVersion() const {
+    return histogram_.publishedVersion();
+  }
+  /**
+   * Number of samples gathered up to the latest snapshot, including the ones
+   * that fell outside of it. Safe to call from any thread.
+   */
+  [[nodiscard]] uint64_t sampleCount() const {
+    return publishedSamples_.load(std::memory_order_relaxed);
   }
 
  public slots:
-  void addPoint(const chaoskit::core::Point &point, float color);
+  /** Adds every sample queued in the ring to the histogram. */
+  void drain();
+  /** Drains the ring and publishes a snapshot right away. */
+  void flush();
   void setSize(const QSize &size);
-  void setColorMap(const chaoskit::core::ColorMap *colorMap);
+  /**
+   * Gathers into a histogram of reduced resolution, where each pixel gets
+   * many more samples, so that a recognizable image appears sooner. Samples
+   * are weighted by pixel area, so the density doesn't change.
+   */
+  void setInteractive(bool interactive);
+  /**
+   * Sorts samples by histogram tile before adding them, which pays off once
+   * the histogram doesn't fit in cache.
+   */
+  void setBinning(bool binning);
   void clear();
+  /** Multiplies the histogram by `factor` on the next publish. */
+  void decay(float factor);
+
+ signals:
+  /** flush() published everything it found in the ring. */
+  void flushed();
 
  private:
   QTransform imageSpaceTransform_;
-  QMutex mutex_;
-  core::HistogramBuffer buffer_;
-  const core::ColorMap *colorMap_ = nullptr;
+  QSize size_{0, 0};
+  /** Size of the histogram, size_ reduced in interactive mode. */
+  QSize resolution_{0, 0};
+  bool interactive_ = false;
+  float sampleWeight_ = 1.f;
+  /** Nothing was gathered since the last clear(), so nothing to resample. */
+  bool empty_ = true;
+  /** Samples land all over the image, tiles keep them closer in memory. */
+  core::ConcurrentHistogram histogram_{
+      0, 0, core::HistogramBuffer::Layout::Tiled};
+  core::ConcurrentHistogram::Writer &writer_;
+  bool binning_ = false;
+  core::TileBinner binner_;
+  std::shared_ptr<SampleRing> ring_;
+  std::vector<Sample> samples_;
+  uint64_t gatheredSamples_ = 0;
+  std::atomic<uint64_t> publishedSamples_{0};
+  QElapsedTimer publishTimer_;
 
+  void publish();
+  void addSamples(const Sample *samples, size_t count);
+  void flushBinner();
+  void updateResolution();
   void updateImageSpaceTransform(const QSizeF &size);
 };
 
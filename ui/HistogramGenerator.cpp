@@ -1,64 +1,90 @@
 #include "HistogramGenerator.h"
-#include <core/ThreadLocalRng.h>
+#include <core/FastRng.h>
 #include <QDebug>
 
+using chaoskit::core::FastRng;
 using chaoskit::core::HistogramBuffer;
 using chaoskit::core::Point;
-using chaoskit::core::ThreadLocalRng;
 
 namespace chaoskit::ui {
 
 HistogramGenerator::HistogramGenerator(QObject *parent) : QObject(parent) {
   thread_ = new QThread();
   thread_->setObjectName("HistogramGenerator");
+  gathererThread_ = new QThread();
+  gathererThread_->setObjectName("HistogramGatherer");
 
-  blenderTask_ = new BlenderTask(std::make_shared<ThreadLocalRng>());
+  auto ring = std::make_shared<SampleRing>(RING_CAPACITY);
+  // The blender only runs on its own thread, so it can own its generator,
+  // which the interpreter then calls without virtual dispatch.
+  blenderTask_ = new BlenderTask(std::make_shared<FastRng>(), ring);
   blenderTask_->moveToThread(thread_);
-  gathererTask_ = new GathererTask();
-  gathererTask_->moveToThread(thread_);
+  gathererTask_ = new GathererTask(ring);
+  gathererTask_->moveToThread(gathererThread_);
 
   connect(thread_, &QThread::finished, blenderTask_, &QObject::deleteLater);
-  connect(thread_, &QThread::finished, gathererTask_, &QObject::deleteLater);
+  connect(gathererThread_, &QThread::finished, gathererTask_,
+          &QObject::deleteLater);
   connect(blenderTask_, &BlenderTask::started, this,
           &HistogramGenerator::started);
-  connect(blenderTask_, &BlenderTask::stopped, this,
-          &HistogramGenerator::stopped);
 
-  connect(blenderTask_, &BlenderTask::stepCompleted, gathererTask_,
-          &GathererTask::addPoint);
+  connect(blenderTask_, &BlenderTask::samplesAvailable, gathererTask_,
+          &GathererTask::drain);
+  // Publishes the last samples even if the renderer is idle, and only then
+  // reports the generator as stopped.
+  connect(blenderTask_, &BlenderTask::stopped, gathererTask_,
+          &GathererTask::flush);
+  connect(gathererTask_, &GathererTask::flushed, this,
+          &HistogramGenerator::stopped);
 
   thread_->start();
+  gathererThread_->start();
 }
 
 HistogramGenerator::~HistogramGenerator() {
   stop();
   thread_->quit();
   thread_->wait();
+  gathererThread_->quit();
+  gathererThread_->wait();
 }
 
 void HistogramGenerator::withHistogram(
     const std::function<void(const HistogramBuffer &)> &action) {
-  // No MetaObject because the mutex handles synchronization.
+  // No MetaObject because the gatherer hands out snapshots.
   gathererTask_->withHistogram(action);
 }
 
 void HistogramGenerator::setSystem(const core::System *system) {
+  blenderTask_->interrupt();
   QMetaObject::invokeMethod(
       blenderTask_, [this, system] { blenderTask_->setSystem(system); });
 }
 
-void HistogramGenerator::setColorMap(const chaoskit::core::ColorMap *colorMap) {
-  QMetaObject::invokeMethod(gathererTask_, [colorMap, this] {
-    gathererTask_->setColorMap(colorMap);
-  });
+void HistogramGenerator::setParams(const core::System *system) {
+  blenderTask_->interrupt();
+  QMetaObject::invokeMethod(
+      blenderTask_, [this, system] { blenderTask_->setParams(system); });
 }
 
 void HistogramGenerator::setSize(quint32 width, quint32 height) {
   QMetaObject::invokeMethod(
-      blenderTask_, [=] { gathererTask_->setSize(QSize(width, height)); });
+      gathererTask_, [=] { gathererTask_->setSize(QSize(width, height)); });
+}
+
+void HistogramGenerator::setInteractive(bool interactive) {
+  QMetaObject::invokeMethod(gathererTask_, [=] {
+    gathererTask_->setInteractive(interactive);
+  });
+}
+
+void HistogramGenerator::setBinning(bool binning) {
+  QMetaObject::invokeMethod(gathererTask_,
+                            [=] { gathererTask_->setBinning(binning); });
 }
 
 void HistogramGenerator::setTtl(int32_t ttl) {
+  blenderTask_->interrupt();
   QMetaObject::invokeMethod(blenderTask_, [=] { blenderTask_->setTtl(ttl); });
 }
 
@@ -68,12 +94,17 @@ void HistogramGenerator::start() {
 }
 
 void HistogramGenerator::stop() {
+  blenderTask_->interrupt();
   QMetaObject::invokeMethod(blenderTask_, &BlenderTask::stop);
   running_ = false;
 }
 void HistogramGenerator::clear() {
-  // No MetaObject because the mutex handles synchronization.
-  gathererTask_->clear();
+  QMetaObject::invokeMethod(gathererTask_, &GathererTask::clear);
+}
+
+void HistogramGenerator::decay(float factor) {
+  QMetaObject::invokeMethod(gathererTask_,
+                            [=] { gathererTask_->decay(factor); });
 }
 
 }  // namespace chaoskit::ui
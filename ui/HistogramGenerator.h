@@ -12,6 +12,9 @@ namespace chaoskit::ui {
 class HistogramGenerator : public QObject {
   Q_OBJECT
  public:
+  /** Number of samples the blender can be ahead of the gatherer. */
+  static constexpr size_t RING_CAPACITY = 1 << 16;
+
   explicit HistogramGenerator(QObject *parent = nullptr);
   ~HistogramGenerator() override;
 
@@ -19,22 +22,37 @@ class HistogramGenerator : public QObject {
       const std::function<void(const core::HistogramBuffer &)> &action);
 
   [[nodiscard]] bool running() const { return running_; }
+  [[nodiscard]] uint64_t histogramVersion() const {
+    return gathererTask_->histogramVersion();
+  }
+  [[nodiscard]] uint64_t sampleCount() const {
+    return gathererTask_->sampleCount();
+  }
 
  public slots:
   void setSystem(const chaoskit::core::System *system);
-  void setColorMap(const chaoskit::core::ColorMap *colorMap);
+  /** Updates parameter values of the current system, keeping its state. */
+  void setParams(const chaoskit::core::System *system);
   void setSize(quint32 width, quint32 height);
+  /** Trades resolution for speed while the system is being edited. */
+  void setInteractive(bool interactive);
+  /** Sorts samples by tile before adding them, for large histograms. */
+  void setBinning(bool binning);
   void setTtl(int32_t ttl);
   void start();
   void stop();
   void clear();
+  /** Fades the histogram out by `factor` instead of clearing it. */
+  void decay(float factor);
 
  signals:
   void started();
+  /** Emitted once the last samples are in the histogram. */
   void stopped();
 
  private:
   QThread *thread_;
+  QThread *gathererThread_;
   BlenderTask *blenderTask_;
   GathererTask *gathererTask_;
   bool running_ = false;
@@ -0,0 +1,20 @@
+#ifndef CHAOSKIT_UI_SAMPLERING_H
+#define CHAOSKIT_UI_SAMPLERING_H
+
+#include <core/SpscRing.h>
+
+namespace chaoskit::ui {
+
+/** A point computed by the blender, in system coordinates. */
+struct Sample {
+  float x;
+  float y;
+  float color;
+};
+
+/** Carries samples from BlenderTask to GathererTask. */
+using SampleRing = core::SpscRing<Sample>;
+
+}  // namespace chaoskit::ui
+
+#endif  // CHAOSKIT_UI_SAMPLERING_H
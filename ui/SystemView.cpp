@@ -27,11 +27,11 @@ class HistogramRenderer : public QQuickFramebufferObject::Renderer {
     toneMapper_.setGamma(systemView_->gamma());
     toneMapper_.setExposure(systemView_->exposure());
     toneMapper_.setVibrancy(systemView_->vibrancy());
+    toneMapper_.setColorMap(systemView_->selectedColorMap());
   }
 
   void render() override {
     toneMapper_.map();
-    update();
 
     systemView_->window()->resetOpenGLState();
   }
@@ -53,6 +53,22 @@ SystemView::SystemView(QQuickItem *parent) : QQuickFramebufferObject(parent) {
           &SystemView::runningChanged);
   connect(generator_, &HistogramGenerator::stopped, this,
           &SystemView::runningChanged);
+
+  pacingTimer_ = new QTimer(this);
+  pacingTimer_->setInterval(PACING_INTERVAL_MS);
+  connect(pacingTimer_, &QTimer::timeout, this, &SystemView::pace);
+  connect(generator_, &HistogramGenerator::started, this,
+          &SystemView::startPacing);
+  // The last samples are published after pacing may have given up.
+  connect(generator_, &HistogramGenerator::stopped, this,
+          &SystemView::startPacing);
+  sinceRedraw_.start();
+
+  interactiveTimer_ = new QTimer(this);
+  interactiveTimer_->setInterval(INTERACTIVE_TIMEOUT_MS);
+  interactiveTimer_->setSingleShot(true);
+  connect(interactiveTimer_, &QTimer::timeout, this,
+          &SystemView::endInteraction);
 }
 
 void SystemView::withHistogram(
@@ -68,7 +84,11 @@ void SystemView::start() { generator_->start(); }
 
 void SystemView::stop() { generator_->stop(); }
 
-void SystemView::clear() { generator_->clear(); }
+void SystemView::clear() {
+  generator_->clear();
+  // The cleared histogram is published asynchronously.
+  startPacing();
+}
 
 void SystemView::setRunning(bool running) {
   if (generator_->running() == running) {
@@ -96,11 +116,30 @@ void SystemView::setModel(DocumentModel *documentModel) {
 
   connect(documentModel, &DocumentModel::structureChanged, this,
           &SystemView::updateSystem);
+  connect(documentModel, &DocumentModel::paramsChanged, this,
+          &SystemView::updateParams);
 }
 
 void SystemView::updateSystem() {
   generator_->setSystem(model_->system());
-  generator_->clear();
+  // Clearing first spares resampling the old histogram to the interactive
+  // resolution only to throw it away.
+  clear();
+  startInteraction();
+  update();
+}
+
+void SystemView::updateParams() {
+  generator_->setParams(model_->system());
+  if (paramsDecay_ > 0.f) {
+    // What fades out is resampled to the interactive resolution.
+    startInteraction();
+    generator_->decay(paramsDecay_);
+    startPacing();
+  } else {
+    clear();
+    startInteraction();
+  }
   update();
 }
 
@@ -111,7 +150,7 @@ void SystemView::setTtl(int ttl) {
 
   ttl_ = ttl;
   generator_->setTtl(ttl);
-  generator_->clear();
+  clear();
   update();
   emit ttlChanged();
 }
@@ -173,12 +212,92 @@ void SystemView::updateColorMap() {
     return;
   }
 
-  generator_->setColorMap(colorMapRegistry_->get(colorMap_));
+  // Colors are only applied when tone mapping, so the histogram is kept.
+  selectedColorMap_ = colorMapRegistry_->get(colorMap_);
 }
 
 void SystemView::updateBufferSize() {
   generator_->setSize(static_cast<quint32>(width()),
                       static_cast<quint32>(height()));
+  startPacing();
+}
+
+void SystemView::setRedrawSampleThreshold(int threshold) {
+  if (threshold == redrawSampleThreshold_) {
+    return;
+  }
+
+  redrawSampleThreshold_ = threshold;
+  emit redrawSampleThresholdChanged();
+}
+
+void SystemView::setMaxRedrawInterval(int interval) {
+  if (interval == maxRedrawInterval_) {
+    return;
+  }
+
+  maxRedrawInterval_ = interval;
+  emit maxRedrawIntervalChanged();
+}
+
+void SystemView::setParamsDecay(float decay) {
+  if (qFuzzyCompare(paramsDecay_, decay)) {
+    return;
+  }
+
+  paramsDecay_ = decay;
+  emit paramsDecayChanged();
+}
+
+void SystemView::setBinning(bool binning) {
+  if (binning == binning_) {
+    return;
+  }
+
+  binning_ = binning;
+  generator_->setBinning(binning);
+  emit binningChanged();
+}
+
+void SystemView::startInteraction() {
+  generator_->setInteractive(true);
+  interactiveTimer_->start();
+}
+
+void SystemView::endInteraction() {
+  // Refines the image at full resolution from here.
+  generator_->setInteractive(false);
+  startPacing();
+}
+
+void SystemView::startPacing() {
+  if (!pacingTimer_->isActive()) {
+    pacingTimer_->start();
+  }
+}
+
+void SystemView::pace() {
+  uint64_t version = generator_->histogramVersion();
+  if (version == drawnVersion_) {
+    // Keep checking while running, the next samples may come any time.
+    if (!running()) {
+      pacingTimer_->stop();
+    }
+    return;
+  }
+
+  uint64_t samples = generator_->sampleCount();
+  // Once stopped, only a few last samples or a clear can be left to show.
+  // During edits, every update counts.
+  if (!running() || interactiveTimer_->isActive() ||
+      samples - drawnSamples_ >=
+          static_cast<uint64_t>(redrawSampleThreshold_) ||
+      sinceRedraw_.elapsed() >= maxRedrawInterval_) {
+    drawnVersion_ = version;
+    drawnSamples_ = samples;
+    sinceRedraw_.restart();
+    update();
+  }
 }
 
 }  // namespace chaoskit::ui
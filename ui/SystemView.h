@@ -1,7 +1,9 @@
 #ifndef CHAOSKIT_UI_SYSTEMVIEW_H
 #define CHAOSKIT_UI_SYSTEMVIEW_H
 
+#include <QElapsedTimer>
 #include <QQuickFramebufferObject>
+#include <QTimer>
 #include "ColorMapRegistry.h"
 #include "DocumentModel.h"
 #include "HistogramGenerator.h"
@@ -23,7 +25,22 @@ class SystemView : public QQuickFramebufferObject {
                  setColorMapRegistry NOTIFY colorMapRegistryChanged)
   Q_PROPERTY(
       QString colorMap READ colorMap WRITE setColorMap NOTIFY colorMapChanged)
+  Q_PROPERTY(int redrawSampleThreshold READ redrawSampleThreshold WRITE
+                 setRedrawSampleThreshold NOTIFY redrawSampleThresholdChanged)
+  Q_PROPERTY(int maxRedrawInterval READ maxRedrawInterval WRITE
+                 setMaxRedrawInterval NOTIFY maxRedrawIntervalChanged)
+  Q_PROPERTY(float paramsDecay READ paramsDecay WRITE setParamsDecay NOTIFY
+                 paramsDecayChanged)
+  Q_PROPERTY(bool binning READ binning WRITE setBinning NOTIFY binningChanged)
  public:
+  /** How often the view checks whether the histogram is worth redrawing. */
+  static constexpr int PACING_INTERVAL_MS = 16;
+  /**
+   * How long after the last edit the view keeps rendering at reduced
+   * resolution.
+   */
+  static constexpr int INTERACTIVE_TIMEOUT_MS = 300;
+
   explicit SystemView(QQuickItem *parent = nullptr);
 
   Renderer *createRenderer() const override;
@@ -40,6 +57,26 @@ class SystemView : public QQuickFramebufferObject {
     return colorMapRegistry_;
   }
   [[nodiscard]] const QString &colorMap() const { return colorMap_; }
+  /** The color map named by colorMap(), if there is one. */
+  [[nodiscard]] const core::ColorMap *selectedColorMap() const {
+    return selectedColorMap_;
+  }
+  /** Number of new samples that trigger a redraw. */
+  [[nodiscard]] int redrawSampleThreshold() const {
+    return redrawSampleThreshold_;
+  }
+  /**
+   * Longest time in milliseconds between redraws while new samples keep
+   * coming in, however few.
+   */
+  [[nodiscard]] int maxRedrawInterval() const { return maxRedrawInterval_; }
+  /**
+   * Part of the histogram kept when only parameter values change, 0 clears
+   * it.
+   */
+  [[nodiscard]] float paramsDecay() const { return paramsDecay_; }
+  /** Whether samples are sorted by tile before being added. */
+  [[nodiscard]] bool binning() const { return binning_; }
 
  public slots:
   void start();
@@ -53,6 +90,10 @@ class SystemView : public QQuickFramebufferObject {
   void setVibrancy(float vibrancy);
   void setColorMapRegistry(ColorMapRegistry *colorMapRegistry);
   void setColorMap(const QString &name);
+  void setRedrawSampleThreshold(int threshold);
+  void setMaxRedrawInterval(int interval);
+  void setParamsDecay(float decay);
+  void setBinning(bool binning);
 
  signals:
   void runningChanged();
@@ -63,6 +104,10 @@ class SystemView : public QQuickFramebufferObject {
   void vibrancyChanged();
   void colorMapRegistryChanged();
   void colorMapChanged();
+  void redrawSampleThresholdChanged();
+  void maxRedrawIntervalChanged();
+  void paramsDecayChanged();
+  void binningChanged();
 
  private:
   HistogramGenerator *generator_;
@@ -74,11 +119,29 @@ class SystemView : public QQuickFramebufferObject {
   float vibrancy_ = 0.f;
   ColorMapRegistry *colorMapRegistry_ = nullptr;
   QString colorMap_ = "Rainbow";
+  const core::ColorMap *selectedColorMap_ = nullptr;
+  float paramsDecay_ = 0.f;
+  bool binning_ = false;
+
+  int redrawSampleThreshold_ = 250000;
+  int maxRedrawInterval_ = 100;
+  QTimer *pacingTimer_;
+  QElapsedTimer sinceRedraw_;
+  uint64_t drawnVersion_ = 0;
+  uint64_t drawnSamples_ = 0;
+
+  QTimer *interactiveTimer_;
+
+  void startPacing();
+  void startInteraction();
 
  private slots:
   void updateColorMap();
   void updateSystem();
+  void updateParams();
   void updateBufferSize();
+  void pace();
+  void endInteraction();
 };
 
 }  // namespace chaoskit::ui
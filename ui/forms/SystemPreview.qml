@@ -6,23 +6,13 @@ import ChaosKit 1.0
 SystemView {
   id: systemView
 
-  property bool autoRefresh: true
-  property int refreshInterval: 100
-
   colorMap: documentModel.documentProxy.colorMap
   colorMapRegistry: globalColorMapRegistry
   height: documentModel.documentProxy.height
+  maxRedrawInterval: 100
   model: documentModel
   scale: 1.0 / Screen.devicePixelRatio
+  redrawSampleThreshold: 250000
   ttl: 20
   width: documentModel.documentProxy.width
-
-  Timer {
-    interval: parent.refreshInterval
-    running: parent.autoRefresh && parent.running
-    repeat: true
-    onTriggered: {
-      systemView.update();
-    }
-  }
 }